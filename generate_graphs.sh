@@ -7,12 +7,12 @@ MAX_WEIGHT=42
 # Usage printing + exit
 function printUsageAndExit()
 {
-	>&2 echo "Usage: $0 <nb vertices> <density> <nb graphs> <path>"
+	>&2 echo "Usage: $0 <nb vertices> <density> <nb graphs> <path> [generator options]"
 	exit 1
 }
 
 # Command line arguments
-if [ $# -ne 4 ]; then
+if [ $# -lt 4 ]; then
 	printUsageAndExit
 fi
 
@@ -20,27 +20,9 @@ ARG_nb_vertices=$1
 ARG_density=$2
 ARG_nb_graphs=$3
 ARG_path=$4
+shift 4
 
-# Generate a graph path for a given num
-function getGraphPath() # num
-{
-	local base="/graph_"
-	local fullpath="$ARG_path$base$1"
-
-	echo "$fullpath"
-}
-
-# Generate a graph and print it to the desired output file
-function genGraph() # num
-{
-	local num="$1"
-	local path=$( getGraphPath "$num")
-
-	# Graph generated using external program
-	./build/generator "$ARG_nb_vertices" "$ARG_density" "$MIN_WEIGHT" "$MAX_WEIGHT" 1> "$path"
-}
-
-# Generate ARG_nb_graphs graphs
-for ((i=0; i<ARG_nb_graphs; i++)); do
-	genGraph "$i"
-done
+# Generate the ARG_nb_graphs graphs (path/graph_0, path/graph_1...) in parallel,
+# with a manifest of their seeds and checksums (path/manifest)
+./build/generator --corpus "$ARG_nb_graphs" --output-dir "$ARG_path" "$@" \
+	"$ARG_nb_vertices" "$ARG_density" "$MIN_WEIGHT" "$MAX_WEIGHT"
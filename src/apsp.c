@@ -0,0 +1,357 @@
+//------------------------------------------------------------------------------
+// ALL-PAIRS SHORTEST PATHS
+//------------------------------------------------------------------------------
+// Computation of the distances between all the pairs of vertexes of a (dense)
+// graph, with a cache-blocked Floyd-Warshall algorithm:
+// for each diagonal block k, (1) the block (k, k) is updated, then (2) all the
+// blocks of row and column k (in parallel), and (3) all the remaining blocks
+// (in parallel). The inner min-plus kernels use SSE4.1/AVX2 when available.
+//
+// The distance matrix is directly computed in a memory-mapped output file.
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "toolbox.h"
+#include "graph.h"
+#include "dijkstra.h"
+#include "parallel.h"
+#include "apsp.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define APSP_USE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+// Default parameters
+#define DEFAULT_BLOCK_SIZE 64
+
+//------------------------------------------------------------------------------
+// MIN-PLUS KERNELS
+//------------------------------------------------------------------------------
+
+void minPlusRowScalar (int32_t* c, const int32_t* b, int32_t a, int length)
+{
+	for (int j = 0; j < length; j++)
+	{
+		int32_t new_length = a + b[j];
+		if (new_length < c[j])
+			c[j] = new_length;
+	}
+}
+
+#ifdef APSP_USE_X86_SIMD
+
+__attribute__((target("sse4.1")))
+void minPlusRowSSE41 (int32_t* c, const int32_t* b, int32_t a, int length)
+{
+	__m128i a_vector = _mm_set1_epi32(a);
+
+	int j = 0;
+	for (; j + 4 <= length; j += 4)
+	{
+		__m128i b_vector = _mm_loadu_si128((const __m128i*) (b + j));
+		__m128i c_vector = _mm_loadu_si128((const __m128i*) (c + j));
+
+		c_vector = _mm_min_epi32(c_vector, _mm_add_epi32(a_vector, b_vector));
+		_mm_storeu_si128((__m128i*) (c + j), c_vector);
+	}
+
+	minPlusRowScalar(c + j, b + j, a, length - j);
+}
+
+__attribute__((target("avx2")))
+void minPlusRowAVX2 (int32_t* c, const int32_t* b, int32_t a, int length)
+{
+	__m256i a_vector = _mm256_set1_epi32(a);
+
+	int j = 0;
+	for (; j + 8 <= length; j += 8)
+	{
+		__m256i b_vector = _mm256_loadu_si256((const __m256i*) (b + j));
+		__m256i c_vector = _mm256_loadu_si256((const __m256i*) (c + j));
+
+		c_vector = _mm256_min_epi32(c_vector, _mm256_add_epi32(a_vector, b_vector));
+		_mm256_storeu_si256((__m256i*) (c + j), c_vector);
+	}
+
+	minPlusRowScalar(c + j, b + j, a, length - j);
+}
+
+#else
+
+// Without x86 SIMD support, the vectorized versions fall back to scalar code
+void minPlusRowSSE41 (int32_t* c, const int32_t* b, int32_t a, int length)
+{
+	minPlusRowScalar(c, b, a, length);
+}
+
+void minPlusRowAVX2 (int32_t* c, const int32_t* b, int32_t a, int length)
+{
+	minPlusRowScalar(c, b, a, length);
+}
+
+#endif
+
+// Runtime dispatch, according to the instruction sets supported by the CPU
+MinPlusRowFunction selectMinPlusRowFunction ()
+{
+	switch (getSupportedSimdLevel())
+	{
+		case SIMD_AVX2:
+			return minPlusRowAVX2;
+		case SIMD_SSE41:
+			return minPlusRowSSE41;
+		default:
+			return minPlusRowScalar;
+	}
+}
+
+//------------------------------------------------------------------------------
+// BLOCKED FLOYD-WARSHALL
+//------------------------------------------------------------------------------
+
+// Initial matrix: null diagonal, lightest edge between two vertexes, or infinity
+void initDistanceMatrix (Graph* graph, int32_t* values)
+{
+	long nb_vertexes = graph->nb_vertexes;
+
+	for (long i = 0; i < nb_vertexes; i++)
+	{
+		int32_t* row = values + i * nb_vertexes;
+
+		for (long j = 0; j < nb_vertexes; j++)
+			row[j] = APSP_INF;
+		row[i] = 0;
+
+		for (Edge* edge = graph->edges[i]; edge != NULL; edge = edge->next)
+			if (edge->weight < row[edge->destination])
+				row[edge->destination] = edge->weight;
+	}
+}
+
+// The last block may be smaller than the others
+int getBlockLength (BlockedMatrix* matrix, int block)
+{
+	int start = block * matrix->block_size;
+	int end   = start + matrix->block_size;
+
+	return (end > matrix->nb_vertexes ? matrix->nb_vertexes : end) - start;
+}
+
+// C = min(C, A + B), where C = block (i, j), A = block (i, k), B = block (k, j)
+// The loop over k is the outer one, so that C can be A or B (phases 1 and 2)
+void updateBlock (BlockedMatrix* matrix, int row_block, int column_block, int k_block)
+{
+	long stride = matrix->nb_vertexes;
+	long row_start 	  = (long) row_block * matrix->block_size;
+	long column_start = (long) column_block * matrix->block_size;
+	long k_start 	  = (long) k_block * matrix->block_size;
+
+	int nb_rows 	= getBlockLength(matrix, row_block);
+	int nb_columns 	= getBlockLength(matrix, column_block);
+	int nb_k 		= getBlockLength(matrix, k_block);
+
+	for (int k = 0; k < nb_k; k++)
+	{
+		const int32_t* b_row = matrix->values + (k_start + k) * stride + column_start;
+
+		for (int i = 0; i < nb_rows; i++)
+		{
+			int32_t* c_row = matrix->values + (row_start + i) * stride + column_start;
+			int32_t a = matrix->values[(row_start + i) * stride + k_start + k];
+
+			if (a < APSP_INF)
+				matrix->minPlusRow(c_row, b_row, a, nb_columns);
+		}
+	}
+}
+
+// Phase 2: blocks of the current row and column (tasks are taken dynamically)
+void runRowColumnPhase (int thread_num, int nb_threads, void* argument)
+{
+	(void) thread_num;
+	(void) nb_threads;
+
+	BlockedMatrix* matrix = argument;
+	int k = matrix->current_block;
+
+	while (true)
+	{
+		int task = __atomic_fetch_add(&matrix->next_task, 1, __ATOMIC_RELAXED);
+		if (task >= 2 * matrix->nb_blocks)
+			break;
+
+		int other_block = task % matrix->nb_blocks;
+		if (other_block == k)
+			continue;
+
+		if (task < matrix->nb_blocks)
+			updateBlock(matrix, k, other_block, k);
+		else
+			updateBlock(matrix, other_block, k, k);
+	}
+}
+
+// Phase 3: all the other blocks (tasks are taken dynamically)
+void runRemainingBlocksPhase (int thread_num, int nb_threads, void* argument)
+{
+	(void) thread_num;
+	(void) nb_threads;
+
+	BlockedMatrix* matrix = argument;
+	int k = matrix->current_block;
+
+	while (true)
+	{
+		int task = __atomic_fetch_add(&matrix->next_task, 1, __ATOMIC_RELAXED);
+		if (task >= matrix->nb_blocks * matrix->nb_blocks)
+			break;
+
+		int row_block 	 = task / matrix->nb_blocks;
+		int column_block = task % matrix->nb_blocks;
+
+		if (row_block != k && column_block != k)
+			updateBlock(matrix, row_block, column_block, k);
+	}
+}
+
+// The given matrix must have been initialized with initDistanceMatrix()
+void computeAllPairsShortestPaths (int32_t* values, int nb_vertexes,
+								   int block_size, int nb_threads)
+{
+	BlockedMatrix matrix;
+	matrix.values 	   = values;
+	matrix.nb_vertexes = nb_vertexes;
+	matrix.block_size  = block_size;
+	matrix.nb_blocks   = (nb_vertexes + block_size - 1) / block_size;
+	matrix.minPlusRow  = selectMinPlusRowFunction();
+
+	for (int k = 0; k < matrix.nb_blocks; k++)
+	{
+		matrix.current_block = k;
+
+		// 1. Diagonal block
+		updateBlock(&matrix, k, k, k);
+
+		// 2. Row and column of the diagonal block
+		matrix.next_task = 0;
+		runInParallel(nb_threads, runRowColumnPhase, &matrix);
+
+		// 3. Remaining blocks
+		matrix.next_task = 0;
+		runInParallel(nb_threads, runRemainingBlocksPhase, &matrix);
+	}
+
+	// Unreachable pairs follow the conventions of Dijkstra's algorithms
+	long nb_values = (long) nb_vertexes * nb_vertexes;
+	for (long i = 0; i < nb_values; i++)
+		if (values[i] >= APSP_INF)
+			values[i] = INF_LENGTH;
+}
+
+//------------------------------------------------------------------------------
+// OUTPUT FILE
+//------------------------------------------------------------------------------
+
+// Create the output file, map it in memory and write its header
+// Returns a pointer to the (mapped) distance matrix
+int32_t* mapOutputMatrix (char* path, int nb_vertexes, size_t* mapping_size)
+{
+	int file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (file < 0)
+	{
+		fprintf(stderr, "Error: output file %s cannot be created.\n", path);
+		exit(1);
+	}
+
+	*mapping_size = sizeof(APSPFileHeader)
+				  + (size_t) nb_vertexes * nb_vertexes * sizeof(int32_t);
+
+	if (ftruncate(file, *mapping_size) != 0)
+	{
+		fprintf(stderr, "Error: output file %s cannot be resized.\n", path);
+		exit(1);
+	}
+
+	void* mapping = mmap(NULL, *mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	if (mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "Error: output file %s cannot be mapped.\n", path);
+		exit(1);
+	}
+	close(file);
+
+	APSPFileHeader* header = mapping;
+	memcpy(header->magic, APSP_FILE_MAGIC, 4);
+	header->nb_vertexes = nb_vertexes;
+	header->reserved 	= 0;
+
+	return (int32_t*) (header + 1);
+}
+
+//------------------------------------------------------------------------------
+// MAIN PROGRAM
+//------------------------------------------------------------------------------
+
+void printUsageAndExit (char* argv[])
+{
+	fprintf(stderr,
+			"Usage: %s <graph file> <output file> [nb threads] [block size]\n",
+			argv[0]);
+	exit(1);
+}
+
+int main (int argc, char* argv[])
+{
+	// Try to get the arguments; print usage and exit if it fails
+	if (argc < 1 + 2 || argc > 1 + 4)
+		printUsageAndExit(argv);
+
+	char* graph_path  = argv[1];
+	char* output_path = argv[2];
+	int nb_threads 	  = getNbAvailableCores();
+	int block_size 	  = DEFAULT_BLOCK_SIZE;
+
+	int nb_read_values = 0;
+	if (argc > 3)
+		nb_read_values += sscanf(argv[3], "%d", &nb_threads);
+	if (argc > 4)
+		nb_read_values += sscanf(argv[4], "%d", &block_size);
+
+	if (nb_read_values != argc - 3)
+		printUsageAndExit(argv);
+	if (nb_threads < 1 || block_size < 1)
+		printUsageAndExit(argv);
+
+	// Read the graph
+	FILE* graph_file = fopen(graph_path, "r");
+	if (graph_file == NULL)
+	{
+		fprintf(stderr, "Error: graph file %s cannot be opened.\n", graph_path);
+		exit(1);
+	}
+
+	Graph* graph = createGraphFromFile(graph_file);
+	fclose(graph_file);
+
+	// Compute the distance matrix directly in the output file
+	size_t mapping_size;
+	int32_t* values = mapOutputMatrix(output_path, graph->nb_vertexes, &mapping_size);
+
+	initDistanceMatrix(graph, values);
+	computeAllPairsShortestPaths(values, graph->nb_vertexes, block_size, nb_threads);
+
+	munmap(((APSPFileHeader*) values) - 1, mapping_size);
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+// ALL-PAIRS SHORTEST PATHS
+//------------------------------------------------------------------------------
+
+#ifndef _APSP_H
+#define _APSP_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// Header of the output file, followed by the (row-major) distance matrix:
+// nb_vertexes * nb_vertexes lengths (int32), INF_LENGTH if unreachable
+#define APSP_FILE_MAGIC "APSP"
+typedef struct APSPFileHeader
+{
+	char magic[4];
+	int32_t nb_vertexes;
+	int64_t reserved; // Keeps the matrix aligned on 16 bytes
+} APSPFileHeader;
+
+// Length of the unreachable pairs during the computation
+// (the sum of two of them does not overflow)
+#define APSP_INF (INT32_MAX / 2)
+
+// Update of a row of a block: c[j] = min(c[j], a + b[j])
+typedef void (*MinPlusRowFunction) (int32_t* c, const int32_t* b, int32_t a, int length);
+
+// Matrix split into square blocks, and the work shared by a parallel phase
+typedef struct BlockedMatrix
+{
+	int32_t* values;
+	int nb_vertexes;
+	int block_size;
+	int nb_blocks;
+
+	MinPlusRowFunction minPlusRow;
+
+	// Current diagonal block, and next task to be taken by a thread
+	int current_block;
+	int next_task;
+} BlockedMatrix;
+
+//------------------------------------------------------------------------------
+
+void minPlusRowScalar (int32_t* c, const int32_t* b, int32_t a, int length);
+void minPlusRowSSE41 (int32_t* c, const int32_t* b, int32_t a, int length);
+void minPlusRowAVX2 (int32_t* c, const int32_t* b, int32_t a, int length);
+MinPlusRowFunction selectMinPlusRowFunction ();
+
+void initDistanceMatrix (Graph* graph, int32_t* values);
+int getBlockLength (BlockedMatrix* matrix, int block);
+void updateBlock (BlockedMatrix* matrix, int row_block, int column_block, int k_block);
+void runRowColumnPhase (int thread_num, int nb_threads, void* matrix);
+void runRemainingBlocksPhase (int thread_num, int nb_threads, void* matrix);
+void computeAllPairsShortestPaths (int32_t* values, int nb_vertexes,
+								   int block_size, int nb_threads);
+
+int32_t* mapOutputMatrix (char* path, int nb_vertexes, size_t* mapping_size);
+void printUsageAndExit (char* argv[]);
+
+#endif
@@ -1,187 +1,1153 @@
 //---------------------------------------------------------------
 // BATCH PERFORMANCES TESTS
 //---------------------------------------------------------------
+// Every graph of the batch is loaded, then each algorithm is run
+// a few times without being measured (warm-up), then measured on
+// a number of repetitions. Times are measured in nanoseconds with
+// a monotonic clock; all the measures of an algorithm (on all the
+// graphs) are summarized by their minimum, median, 95th and 99th
+// percentiles.
+//
+// The graphs can be processed concurrently by a pool of workers:
+// each worker takes the next unprocessed graph, and keeps its own
+// measures, which are merged once all the graphs are processed.
+// Workers can be pinned to distinct cores, so that they do not
+// disturb each other's measures more than needed.
+//
+// With prefetching, each worker has a loader thread which reads
+// and parses its next graph while the current one is measured
+// (double buffering); the loading times are then reported apart
+// from the time the worker waited for its graphs.
+//
+// The measures of each graph can also be written on the standard
+// output (JSON or CSV), one record per graph and per algorithm.
+// A CSV output of a previous run can then be given as a baseline:
+// the average median time of each algorithm is compared to the
+// baseline one, and the program exits with a specific code if it
+// got slower than allowed by the threshold. Memory is not compared:
+// only the size of each graph is known exactly, and the peak memory
+// of the process depends on the order and parallelism of the runs.
+//---------------------------------------------------------------
 
 #define _GNU_SOURCE
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <time.h> // Assert precise time measurement is available
 #include <assert.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <sys/resource.h>
 #include "complexity.h"
 #include "graph.h"
+#include "connectivity.h"
 #include "dijkstra.h"
+#include "delta_stepping.h"
+#include "dense_dijkstra.h"
+#include "parallel.h"
 
 // About graph paths
 #define PATH_LENGTH 256
 #define GRAPH_FILE_PREFIX "graph_"
 
+// Default numbers of unmeasured and measured runs of each algorithm
+#define DEFAULT_NB_WARMUP_RUNS 1
+#define DEFAULT_NB_REPETITIONS 5
+
+// Default allowed slowdown (in percents) before a regression is reported
+#define DEFAULT_REGRESSION_THRESHOLD 10.0
+
+// Exit code of a run slower than its baseline
+#define REGRESSION_EXIT_CODE 2
+
+#define NB_NS_PER_MS 1000000.0
+
+// Maximal length of a line of a baseline file, and of an algorithm identifier
+#define BASELINE_LINE_LENGTH 1024
+#define ALGORITHM_ID_LENGTH 64
+
+// Identifier of the loading measures in the records
+#define LOADING_ID "loading"
+
+// Unknown value of a record (written as null in JSON, and empty in CSV)
+#define UNKNOWN_VALUE -1
+
+// Number of fields of a record
+#define NB_RECORD_FIELDS 10
+
+// Number of benchmarked algorithms (the loading excluded)
+#define NB_ALGORITHMS 6
+
+// Number of the loaded graph once all the graphs have been claimed
+#define NO_GRAPH -1
+
+// Number of graphs a worker and its loader can hold at the same time
+#define NB_LOADER_SLOTS 2
+
+typedef enum OutputFormat
+{
+	TEXT_OUTPUT, // Summary on the standard error only
+	JSON_OUTPUT,
+	CSV_OUTPUT
+} OutputFormat;
+
+// Settings of the batch, given to every benchmarked algorithm
+typedef struct BatchSettings
+{
+	int delta;
+	int nb_threads; // Threads of delta-stepping and Afforest (in each worker)
+	int nb_warmup_runs;
+	int nb_repetitions;
+
+	int nb_workers;
+	bool pin_workers;
+	bool prefetch_graphs;
+
+	OutputFormat output_format;
+	char* baseline_path; // NULL if there is no comparison to a baseline
+	double regression_threshold;
+} BatchSettings;
+
+// Measured execution times (in nanoseconds)
+typedef struct TimeSamples
+{
+	int64_t* values;
+	int nb_values;
+	int capacity;
+} TimeSamples;
+
+// Benchmarked algorithm: the run returns an array to be freed (or NULL)
+typedef int* (*BenchmarkRun) (Graph* g, int source, BatchSettings* settings);
+
+typedef struct BenchmarkedAlgorithm
+{
+	char* name;
+	char* id; // Name used in the records and baselines
+	BenchmarkRun run;
+	TimeSamples samples;
+	long total_complexity;
+	bool has_complexity; // Whether the algorithm updates COMPLEXITY
+
+	// Sum of the median times of every measured graph
+	int64_t total_median_time;
+	int nb_measured_graphs;
+} BenchmarkedAlgorithm;
+
+// Measures of an algorithm on a single graph
+typedef struct AlgorithmMeasure
+{
+	BenchmarkedAlgorithm* algorithm;
+	int nb_runs;
+	int64_t min_time;
+	int64_t median_time;
+	long complexity; // UNKNOWN_VALUE if the algorithm does not update COMPLEXITY
+
+	// High-water mark of the whole process when the measures end (it never
+	// decreases, and is shared by all the workers and loaders)
+	long process_peak_memory;
+} AlgorithmMeasure;
+
+// Measures of a graph (the loading first), written together once the graph
+// is processed
+typedef struct GraphMeasures
+{
+	int graph_num;
+	long nb_vertexes;
+	long nb_edges;
+	long graph_memory; // In kB (UNKNOWN_VALUE if the graph has not been built)
+	AlgorithmMeasure measures[1 + NB_ALGORITHMS];
+	int nb_measures;
+} GraphMeasures;
+
+// Measures of a worker (each algorithm has its own copy of the samples)
+typedef struct BatchWorker
+{
+	BenchmarkedAlgorithm loading;
+	BenchmarkedAlgorithm algorithms[NB_ALGORITHMS];
+
+	long optimized_dijkstra_total_complexity;
+	int nb_connected_graphs;
+	long total_nb_components;
+
+	int nb_processed_graphs;
+	int64_t busy_time;
+	int64_t loading_time; // Spent by the worker or by its loader
+	int64_t waiting_time; // Spent by the worker waiting for its loader
+} BatchWorker;
+
+// State shared by all the workers
+typedef struct Batch
+{
+	char* basepath;
+	int nb_graphs;
+	int next_graph; // Next graph to process (incremented atomically)
+	BatchSettings* settings;
+	BatchWorker* workers;
+
+	// Number of records already written (protected by the lock of stdout)
+	int nb_written_records;
+} Batch;
+
+// Graph loaded by a worker (or by its loader)
+typedef struct LoadedGraph
+{
+	int graph_num; // NO_GRAPH if there was no graph left
+	Graph* graph;  // NULL if the graph is not connected
+	int nb_vertexes;
+	long nb_edges;
+	int nb_components;
+	long complexity;
+	int64_t load_time;
+} LoadedGraph;
+
+// Loader thread of a worker: the graphs are loaded in the slots in turn,
+// and a slot is only reused once the worker has processed its graph
+typedef struct GraphLoader
+{
+	Batch* batch;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+
+	LoadedGraph slots[NB_LOADER_SLOTS];
+	int nb_filled_slots;
+	int64_t busy_time;
+} GraphLoader;
+
+// Average median time of an algorithm in a baseline
+typedef struct BaselineEntry
+{
+	char id[ALGORITHM_ID_LENGTH];
+	int64_t total_median_time;
+	int nb_measured_graphs;
+} BaselineEntry;
+
+typedef struct Baseline
+{
+	BaselineEntry* entries;
+	int nb_entries;
+} Baseline;
+
+//---------------------------------------------------------------
+// TIME MEASUREMENT
 //---------------------------------------------------------------
 
-void printUsageAndExit (char* argv[])
+int64_t getCurrentTimeInNs ()
 {
-	fprintf(stderr,
-			"Usage: %s <graph base path> <nb graphs>\n",
-			argv[0]);
-	exit(1);
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (int64_t) time.tv_sec * 1000000000 + (int64_t) time.tv_nsec;
+}
+
+// Memory used by the adjacency lists of a graph (in kB)
+long getGraphMemoryInKb (Graph* g)
+{
+	size_t size = sizeof(Graph)
+				+ g->nb_vertexes * sizeof(Edge*)
+				+ (g->nb_vertexes + 1) * sizeof(int)
+				+ 2 * g->nb_edges * sizeof(Edge);
+
+	return (long) ((size + 1023) / 1024);
+}
+
+// Peak resident memory of the whole process (in kB) since its start
+long getPeakMemoryInKb ()
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return UNKNOWN_VALUE;
+
+	return usage.ru_maxrss;
+}
+
+void addTimeSample (TimeSamples* samples, int64_t value)
+{
+	if (samples->nb_values == samples->capacity)
+	{
+		samples->capacity = 2 * samples->capacity + 16;
+		samples->values   = realloc(samples->values, samples->capacity * sizeof(int64_t));
+		CHECK_MALLOC(samples->values);
+	}
+
+	samples->values[(samples->nb_values)++] = value;
+}
+
+int compareTimes (const void* time_1, const void* time_2)
+{
+	int64_t value_1 = *((const int64_t*) time_1);
+	int64_t value_2 = *((const int64_t*) time_2);
+
+	return (value_1 > value_2) - (value_1 < value_2);
+}
+
+// Nearest-rank percentile of sorted samples (in nanoseconds)
+int64_t getPercentile (TimeSamples* sorted_samples, double percentile)
+{
+	if (sorted_samples->nb_values == 0)
+		return 0;
+
+	int rank = (int) ((percentile / 100.0) * sorted_samples->nb_values + 0.999999);
+	if (rank < 1)
+		rank = 1;
+	if (rank > sorted_samples->nb_values)
+		rank = sorted_samples->nb_values;
+
+	return sorted_samples->values[rank - 1];
+}
+
+// Minimum and median of the last samples (the ones of the current graph)
+void getLastSamplesStatistics (TimeSamples* samples, int nb_last_samples,
+							   int64_t* min_time, int64_t* median_time)
+{
+	TimeSamples last_samples;
+	last_samples.nb_values = nb_last_samples;
+	last_samples.capacity  = nb_last_samples;
+	last_samples.values    = malloc(nb_last_samples * sizeof(int64_t));
+	CHECK_MALLOC(last_samples.values);
+
+	memcpy(last_samples.values, samples->values + samples->nb_values - nb_last_samples,
+		   nb_last_samples * sizeof(int64_t));
+	qsort(last_samples.values, nb_last_samples, sizeof(int64_t), compareTimes);
+
+	*min_time 	 = getPercentile(&last_samples, 0.0);
+	*median_time = getPercentile(&last_samples, 50.0);
+
+	free(last_samples.values);
+}
+
+void printTimeStatistics (char* name, TimeSamples* samples)
+{
+	qsort(samples->values, samples->nb_values, sizeof(int64_t), compareTimes);
+
+	fprintf(stderr, "%-30s: min %10.4lf | median %10.4lf | p95 %10.4lf | p99 %10.4lf (%d runs)\n",
+			name,
+			(double) getPercentile(samples, 0.0)  / NB_NS_PER_MS,
+			(double) getPercentile(samples, 50.0) / NB_NS_PER_MS,
+			(double) getPercentile(samples, 95.0) / NB_NS_PER_MS,
+			(double) getPercentile(samples, 99.0) / NB_NS_PER_MS,
+			samples->nb_values);
 }
 
+//---------------------------------------------------------------
+// RECORDS
+//---------------------------------------------------------------
+
+void writeRecordsHeader (OutputFormat format)
+{
+	if (format == JSON_OUTPUT)
+		printf("[\n");
+	else if (format == CSV_OUTPUT)
+		printf("graph,n,m,algorithm,runs,min_ns,median_ns,complexity,graph_kb,process_peak_rss_kb\n");
+}
+
+void writeRecordsFooter (OutputFormat format, bool has_records)
+{
+	if (format == JSON_OUTPUT)
+		printf(has_records ? "\n]\n" : "]\n");
+}
+
+void writeRecordValue (OutputFormat format, char* name, long value)
+{
+	if (format == JSON_OUTPUT)
+	{
+		if (value == UNKNOWN_VALUE)
+			printf(", \"%s\": null", name);
+		else
+			printf(", \"%s\": %ld", name, value);
+	}
+	else if (value != UNKNOWN_VALUE)
+		printf(",%ld", value);
+	else
+		printf(",");
+}
+
+// One record of the measures of an algorithm on a graph, written on the
+// standard output
+void writeRecord (OutputFormat format, bool first_record, GraphMeasures* graph_measures,
+				  AlgorithmMeasure* measure)
+{
+	if (format == JSON_OUTPUT)
+		printf("%s{\"graph\": %d", first_record ? "" : ",\n", graph_measures->graph_num);
+	else
+		printf("%d", graph_measures->graph_num);
+
+	writeRecordValue(format, "n", graph_measures->nb_vertexes);
+	writeRecordValue(format, "m", graph_measures->nb_edges);
+
+	if (format == JSON_OUTPUT)
+		printf(", \"algorithm\": \"%s\"", measure->algorithm->id);
+	else
+		printf(",%s", measure->algorithm->id);
+
+	writeRecordValue(format, "runs", measure->nb_runs);
+	writeRecordValue(format, "min_ns", (long) measure->min_time);
+	writeRecordValue(format, "median_ns", (long) measure->median_time);
+	writeRecordValue(format, "complexity", measure->complexity);
+	writeRecordValue(format, "graph_kb", graph_measures->graph_memory);
+	writeRecordValue(format, "process_peak_rss_kb", measure->process_peak_memory);
+
+	printf(format == JSON_OUTPUT ? "}" : "\n");
+}
+
+// The records of a graph are written at once, so that the ones of the graphs
+// processed concurrently are not interleaved
+void writeGraphRecords (Batch* batch, GraphMeasures* graph_measures)
+{
+	OutputFormat format = batch->settings->output_format;
+	if (format == TEXT_OUTPUT)
+		return;
+
+	flockfile(stdout);
+
+	for (int i = 0; i < graph_measures->nb_measures; i++)
+	{
+		writeRecord(format, batch->nb_written_records == 0, graph_measures,
+					&graph_measures->measures[i]);
+		(batch->nb_written_records)++;
+	}
+
+	funlockfile(stdout);
+}
+
+// Summarize the measures of an algorithm on the current graph (the last samples)
+void recordGraphMeasures (BenchmarkedAlgorithm* algorithm, GraphMeasures* graph_measures,
+						  int nb_runs, long complexity)
+{
+	AlgorithmMeasure* measure = &graph_measures->measures[(graph_measures->nb_measures)++];
+
+	getLastSamplesStatistics(&algorithm->samples, nb_runs,
+							 &measure->min_time, &measure->median_time);
+
+	measure->algorithm 			 = algorithm;
+	measure->nb_runs 			 = nb_runs;
+	measure->complexity 		 = algorithm->has_complexity ? complexity : UNKNOWN_VALUE;
+	measure->process_peak_memory = getPeakMemoryInKb();
+
+	algorithm->total_median_time += measure->median_time;
+	(algorithm->nb_measured_graphs)++;
+}
+
+//---------------------------------------------------------------
+// BASELINE
+//---------------------------------------------------------------
+
+BaselineEntry* findBaselineEntry (Baseline* baseline, char* id)
+{
+	for (int i = 0; i < baseline->nb_entries; i++)
+		if (strcmp(baseline->entries[i].id, id) == 0)
+			return &baseline->entries[i];
+
+	return NULL;
+}
+
+// Split a CSV line in place; returns the number of fields (at most max_nb_fields)
+int splitCSVLine (char* line, char** fields, int max_nb_fields)
+{
+	line[strcspn(line, "\r\n")] = '\0';
+
+	int nb_fields = 0;
+	fields[nb_fields++] = line;
+
+	for (char* c = line; *c != '\0' && nb_fields < max_nb_fields; c++)
+		if (*c == ',')
+		{
+			*c = '\0';
+			fields[nb_fields++] = c + 1;
+		}
+
+	return nb_fields;
+}
+
+// A baseline is the CSV output of a previous run (only its median times are used)
+Baseline* readBaseline (char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: cannot open the baseline file %s\n", path);
+		exit(1);
+	}
+
+	Baseline* baseline = malloc(sizeof(Baseline));
+	CHECK_MALLOC(baseline);
+	baseline->entries 	 = NULL;
+	baseline->nb_entries = 0;
+
+	char line[BASELINE_LINE_LENGTH];
+	char* fields[NB_RECORD_FIELDS];
+	int line_num = 0;
+
+	while (fgets(line, BASELINE_LINE_LENGTH, file) != NULL)
+	{
+		// The first line is the header of the columns
+		if (line_num++ == 0)
+			continue;
+
+		long long median_time;
+		if (splitCSVLine(line, fields, NB_RECORD_FIELDS) != NB_RECORD_FIELDS
+		||  sscanf(fields[6], "%lld", &median_time) != 1
+		||  strlen(fields[3]) >= ALGORITHM_ID_LENGTH)
+		{
+			fprintf(stderr, "Error: invalid line %d in the baseline file %s\n", line_num, path);
+			exit(1);
+		}
+
+		BaselineEntry* entry = findBaselineEntry(baseline, fields[3]);
+		if (entry == NULL)
+		{
+			baseline->entries = realloc(baseline->entries,
+										(baseline->nb_entries + 1) * sizeof(BaselineEntry));
+			CHECK_MALLOC(baseline->entries);
+
+			entry = &baseline->entries[(baseline->nb_entries)++];
+			strcpy(entry->id, fields[3]);
+			entry->total_median_time  = 0;
+			entry->nb_measured_graphs = 0;
+		}
+
+		entry->total_median_time += median_time;
+		(entry->nb_measured_graphs)++;
+	}
+
+	fclose(file);
+	return baseline;
+}
+
+void freeBaseline (Baseline* baseline)
+{
+	free(baseline->entries);
+	free(baseline);
+}
+
+// Print the comparison of an algorithm to the baseline, and return true if it
+// is slower than allowed by the threshold
+bool compareToBaseline (BenchmarkedAlgorithm* algorithm, Baseline* baseline,
+						double regression_threshold)
+{
+	BaselineEntry* entry = findBaselineEntry(baseline, algorithm->id);
+	if (entry == NULL || algorithm->nb_measured_graphs == 0)
+	{
+		fprintf(stderr, "%-30s: not compared\n", algorithm->name);
+		return false;
+	}
+
+	double average_time = (double) algorithm->total_median_time
+						/ (double) algorithm->nb_measured_graphs;
+	double baseline_average_time = (double) entry->total_median_time
+								 / (double) entry->nb_measured_graphs;
+
+	double change = baseline_average_time > 0
+				  ? 100.0 * (average_time / baseline_average_time - 1.0)
+				  : 0.0;
+	bool is_regression = change > regression_threshold;
+
+	fprintf(stderr, "%-30s: %10.4lf ms (baseline %10.4lf ms, %+7.2lf%%)%s\n",
+			algorithm->name,
+			average_time / NB_NS_PER_MS,
+			baseline_average_time / NB_NS_PER_MS,
+			change,
+			is_regression ? " REGRESSION" : "");
+
+	return is_regression;
+}
+
+//---------------------------------------------------------------
+// BENCHMARKED ALGORITHMS
+//---------------------------------------------------------------
+
+int* runConnectivity (Graph* g, int source, BatchSettings* settings)
+{
+	(void) source;
+	(void) settings;
+
+	countConnectedComponents(g);
+	return NULL;
+}
+
+// Parallel labeling, and the size histogram computed from the labels
+int* runParallelConnectivity (Graph* g, int source, BatchSettings* settings)
+{
+	(void) source;
+
+	Components* components = computeConnectedComponentsInParallel(g, settings->nb_threads);
+
+	int nb_size_classes;
+	free(computeComponentSizeHistogram(components, &nb_size_classes));
+
+	freeComponents(components);
+	return NULL;
+}
+
+int* runNaiveDijkstra (Graph* g, int source, BatchSettings* settings)
+{
+	(void) settings;
+	return dijkstraNaive(g, source, NULL);
+}
+
+int* runOptimizedDijkstra (Graph* g, int source, BatchSettings* settings)
+{
+	(void) settings;
+	return dijkstra(g, source, NULL);
+}
+
+int* runDeltaStepping (Graph* g, int source, BatchSettings* settings)
+{
+	return deltaStepping(g, source, settings->delta, settings->nb_threads);
+}
+
+int* runDenseDijkstra (Graph* g, int source, BatchSettings* settings)
+{
+	(void) settings;
+	return dijkstraDense(g, source);
+}
+
+// Warm-up runs, then measured runs; returns the complexity of the last run
+// (all the runs do the same work)
+long benchmarkAlgorithm (BenchmarkedAlgorithm* algorithm, Graph* g, int source,
+						 BatchSettings* settings)
+{
+	for (int i = 0; i < settings->nb_warmup_runs; i++)
+		free(algorithm->run(g, source, settings));
+
+	for (int i = 0; i < settings->nb_repetitions; i++)
+	{
+		COMPLEXITY = 0;
+
+		int64_t start_time = getCurrentTimeInNs();
+		int* result = algorithm->run(g, source, settings);
+		int64_t end_time = getCurrentTimeInNs();
+
+		addTimeSample(&algorithm->samples, end_time - start_time);
+		free(result);
+	}
+
+	if (algorithm->has_complexity)
+		algorithm->total_complexity += COMPLEXITY;
+
+	return (long) COMPLEXITY;
+}
+
+// Add the measures of an algorithm in a worker to the measures of all the workers
+void mergeBenchmarkedAlgorithm (BenchmarkedAlgorithm* merged_algorithm,
+								BenchmarkedAlgorithm* algorithm)
+{
+	for (int i = 0; i < algorithm->samples.nb_values; i++)
+		addTimeSample(&merged_algorithm->samples, algorithm->samples.values[i]);
+
+	merged_algorithm->total_complexity 	 += algorithm->total_complexity;
+	merged_algorithm->total_median_time  += algorithm->total_median_time;
+	merged_algorithm->nb_measured_graphs += algorithm->nb_measured_graphs;
+
+	free(algorithm->samples.values);
+}
+
+//---------------------------------------------------------------
+// GRAPHS LOADING
+//---------------------------------------------------------------
+
 char* getFullGraphPath (char* basepath, int graph_num)
 {
 	char* path = malloc(PATH_LENGTH * sizeof(char));
 	CHECK_MALLOC(path);
 
-	int nb_written_var = sprintf(path, "%s%s%d", basepath, GRAPH_FILE_PREFIX, graph_num);
-	// printf("%s\n", path);
-	assert(nb_written_var >= 3);
+	int nb_written_var = snprintf(path, PATH_LENGTH, "%s%s%d", basepath, GRAPH_FILE_PREFIX, graph_num);
+	assert(nb_written_var >= 3 && nb_written_var < PATH_LENGTH);
 
 	return path;
 }
 
-Graph* getGraphFromFile (char* basepath, int graph_num)
+// The graph is NULL if it is not connected (its adjacency lists are then
+// not even built); its size and number of components are known in any case
+void getGraphFromFile (char* basepath, LoadedGraph* loaded_graph)
 {
 	// Compute the file path, and open it
-	char* graph_path = getFullGraphPath(basepath, graph_num);
-	
+	char* graph_path = getFullGraphPath(basepath, loaded_graph->graph_num);
+
 	FILE* graph_file = fopen(graph_path, "r");
 	assert(graph_file != NULL);
 
-	// Create a graph from this file, close it, and return the created graph
-	Graph* graph = createGraphFromFile(graph_file);
-	
+	// Read the edges of this file, close it, and create the graph if it is connected
+	GraphEdgeArray* edge_array = readGraphEdgesFromFile(graph_file);
+
+	loaded_graph->nb_vertexes   = edge_array->nb_vertexes;
+	loaded_graph->nb_edges 	    = edge_array->nb_edges;
+	loaded_graph->nb_components = edge_array->nb_components;
+	loaded_graph->graph 		= edge_array->nb_components <= 1
+								? createGraphFromEdgeArray(edge_array)
+								: NULL;
+
+	freeGraphEdgeArray(edge_array);
 	fclose(graph_file);
 	free(graph_path);
+}
 
-	return graph;
+// Claim the next unprocessed graph, and load it
+void loadNextGraph (Batch* batch, LoadedGraph* loaded_graph)
+{
+	int graph_num = __atomic_fetch_add(&batch->next_graph, 1, __ATOMIC_RELAXED);
+	if (graph_num >= batch->nb_graphs)
+	{
+		loaded_graph->graph_num = NO_GRAPH;
+		return;
+	}
+
+	// The connectivity is tested during the loading, and disconnected graphs
+	// are skipped before their adjacency is built
+	loaded_graph->graph_num = graph_num;
+
+	COMPLEXITY = 0;
+	int64_t start_time = getCurrentTimeInNs();
+	getGraphFromFile(batch->basepath, loaded_graph);
+	int64_t end_time = getCurrentTimeInNs();
+
+	loaded_graph->complexity = (long) COMPLEXITY;
+	loaded_graph->load_time  = end_time - start_time;
+}
+
+void processGraph (Batch* batch, BatchWorker* worker, LoadedGraph* loaded_graph)
+{
+	BatchSettings* settings = batch->settings;
+	Graph* graph = loaded_graph->graph;
+	int origin_vertex = 0;
+
+	GraphMeasures graph_measures;
+	graph_measures.graph_num 	= loaded_graph->graph_num;
+	graph_measures.nb_vertexes 	= loaded_graph->nb_vertexes;
+	graph_measures.nb_edges 	= loaded_graph->nb_edges;
+	graph_measures.graph_memory = graph == NULL ? UNKNOWN_VALUE : getGraphMemoryInKb(graph);
+	graph_measures.nb_measures 	= 0;
+
+	addTimeSample(&worker->loading.samples, loaded_graph->load_time);
+	worker->loading.total_complexity += loaded_graph->complexity;
+	worker->total_nb_components 	 += loaded_graph->nb_components;
+
+	recordGraphMeasures(&worker->loading, &graph_measures, 1, loaded_graph->complexity);
+
+	if (graph != NULL)
+	{
+		(worker->nb_connected_graphs)++;
+
+		for (int a = 0; a < NB_ALGORITHMS; a++)
+		{
+			BenchmarkedAlgorithm* algorithm = &worker->algorithms[a];
+
+			long complexity = benchmarkAlgorithm(algorithm, graph, origin_vertex, settings);
+			recordGraphMeasures(algorithm, &graph_measures, settings->nb_repetitions, complexity);
+		}
+
+		worker->optimized_dijkstra_total_complexity += ComplexityOf_dijkstra(graph, origin_vertex);
+
+		freeGraph(graph);
+	}
+
+	writeGraphRecords(batch, &graph_measures);
 }
 
-double getTimeDifferenceInMs (struct timespec* start, struct timespec* end)
+//---------------------------------------------------------------
+// PREFETCHING
+//---------------------------------------------------------------
+
+// Main loop of a loader thread: the last loaded graph is NO_GRAPH
+void* runGraphLoader (void* argument)
 {
-	return (1000 * ((double) end->tv_sec))   + (((double) end->tv_nsec) / 1000000)
-		 - (1000 * ((double) start->tv_sec)) + (((double) start->tv_nsec) / 1000000);
+	GraphLoader* loader = argument;
+
+	for (int slot = 0; ; slot = (slot + 1) % NB_LOADER_SLOTS)
+	{
+		// Wait for the worker to release the slot
+		pthread_mutex_lock(&loader->mutex);
+		while (loader->nb_filled_slots == NB_LOADER_SLOTS)
+			pthread_cond_wait(&loader->condition, &loader->mutex);
+		pthread_mutex_unlock(&loader->mutex);
+
+		int64_t start_time = getCurrentTimeInNs();
+		loadNextGraph(loader->batch, &loader->slots[slot]);
+		loader->busy_time += getCurrentTimeInNs() - start_time;
+
+		bool is_last_slot = loader->slots[slot].graph_num == NO_GRAPH;
+
+		pthread_mutex_lock(&loader->mutex);
+		(loader->nb_filled_slots)++;
+		pthread_cond_signal(&loader->condition);
+		pthread_mutex_unlock(&loader->mutex);
+
+		if (is_last_slot)
+			return NULL;
+	}
+}
+
+void startGraphLoader (GraphLoader* loader, Batch* batch)
+{
+	loader->batch 			= batch;
+	loader->nb_filled_slots = 0;
+	loader->busy_time 		= 0;
+
+	pthread_mutex_init(&loader->mutex, NULL);
+	pthread_cond_init(&loader->condition, NULL);
+
+	if (pthread_create(&loader->thread, NULL, runGraphLoader, loader) != 0)
+	{
+		fprintf(stderr, "Error: thread creation failed.\n");
+		exit(1);
+	}
+}
+
+void stopGraphLoader (GraphLoader* loader)
+{
+	pthread_join(loader->thread, NULL);
+
+	pthread_cond_destroy(&loader->condition);
+	pthread_mutex_destroy(&loader->mutex);
+}
+
+// The graph of the slot stays valid until it is released
+LoadedGraph* waitForLoadedGraph (GraphLoader* loader, int slot)
+{
+	pthread_mutex_lock(&loader->mutex);
+	while (loader->nb_filled_slots == 0)
+		pthread_cond_wait(&loader->condition, &loader->mutex);
+	pthread_mutex_unlock(&loader->mutex);
+
+	return &loader->slots[slot];
+}
+
+void releaseLoadedGraph (GraphLoader* loader)
+{
+	pthread_mutex_lock(&loader->mutex);
+	(loader->nb_filled_slots)--;
+	pthread_cond_signal(&loader->condition);
+	pthread_mutex_unlock(&loader->mutex);
+}
+
+//---------------------------------------------------------------
+// WORKERS
+//---------------------------------------------------------------
+
+// Each graph is loaded by the worker itself, just before being processed
+void processGraphsSequentially (Batch* batch, BatchWorker* worker)
+{
+	LoadedGraph loaded_graph;
+
+	while (true)
+	{
+		int64_t start_time = getCurrentTimeInNs();
+		loadNextGraph(batch, &loaded_graph);
+		worker->loading_time += getCurrentTimeInNs() - start_time;
+
+		if (loaded_graph.graph_num == NO_GRAPH)
+			break;
+
+		processGraph(batch, worker, &loaded_graph);
+		(worker->nb_processed_graphs)++;
+	}
+}
+
+// The next graph is loaded by the loader thread while the current one is processed
+void processGraphsWithPrefetching (Batch* batch, BatchWorker* worker)
+{
+	GraphLoader loader;
+	startGraphLoader(&loader, batch);
+
+	for (int slot = 0; ; slot = (slot + 1) % NB_LOADER_SLOTS)
+	{
+		int64_t start_time = getCurrentTimeInNs();
+		LoadedGraph* loaded_graph = waitForLoadedGraph(&loader, slot);
+		worker->waiting_time += getCurrentTimeInNs() - start_time;
+
+		if (loaded_graph->graph_num == NO_GRAPH)
+			break;
+
+		processGraph(batch, worker, loaded_graph);
+		(worker->nb_processed_graphs)++;
+
+		releaseLoadedGraph(&loader);
+	}
+
+	stopGraphLoader(&loader);
+	worker->loading_time = loader.busy_time;
+}
+
+// Each worker processes the next unprocessed graph, until there is none left
+void runBatchWorker (int worker_num, int nb_workers, void* argument)
+{
+	(void) nb_workers;
+
+	Batch* batch = argument;
+	BatchWorker* worker = &batch->workers[worker_num];
+
+	// Each worker (with its loader and delta-stepping threads) gets its own cores
+	if (batch->settings->pin_workers)
+	{
+		int nb_threads = batch->settings->nb_threads;
+		if (!pinCurrentThreadToCores(worker_num * nb_threads, nb_threads))
+			fprintf(stderr, "Warning: worker %d could not be pinned\n", worker_num);
+	}
+
+	int64_t start_time = getCurrentTimeInNs();
+
+	if (batch->settings->prefetch_graphs)
+		processGraphsWithPrefetching(batch, worker);
+	else
+		processGraphsSequentially(batch, worker);
+
+	worker->busy_time = getCurrentTimeInNs() - start_time;
+}
+
+//---------------------------------------------------------------
+
+void printUsageAndExit (char* argv[])
+{
+	fprintf(stderr,
+			"Usage: %s [--warmup <nb runs>] [--repetitions <nb runs>]"
+			" [--jobs <nb workers>] [--pin] [--prefetch] [--format text|json|csv]"
+			" [--baseline <csv file>] [--threshold <percents>]"
+			" <graph base path> <nb graphs> [delta] [nb threads]\n",
+			argv[0]);
+	exit(1);
 }
 
 int main (int argc, char* argv[])
 {
-	// Try to get the arguments; print usage and exit if it fails
-	if (argc != 1 + 2)
+	// Delta-stepping parameters (default values are selected if not given)
+	BatchSettings settings;
+	settings.delta 				  = 0;
+	settings.nb_threads 		  = 0;
+	settings.nb_warmup_runs 	  = DEFAULT_NB_WARMUP_RUNS;
+	settings.nb_repetitions 	  = DEFAULT_NB_REPETITIONS;
+	settings.nb_workers 		  = 1;
+	settings.pin_workers 		  = false;
+	settings.prefetch_graphs 	  = false;
+	settings.output_format 		  = TEXT_OUTPUT;
+	settings.baseline_path 		  = NULL;
+	settings.regression_threshold = DEFAULT_REGRESSION_THRESHOLD;
+
+	// Try to get the options and arguments; print usage and exit if it fails
+	char* arguments[4];
+	int nb_arguments = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d", &settings.nb_warmup_runs) != 1
+			||  settings.nb_warmup_runs < 0)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d", &settings.nb_repetitions) != 1
+			||  settings.nb_repetitions < 1)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d", &settings.nb_workers) != 1
+			||  settings.nb_workers < 1)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--pin") == 0)
+			settings.pin_workers = true;
+		else if (strcmp(argv[i], "--prefetch") == 0)
+			settings.prefetch_graphs = true;
+		else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], "text") == 0)
+				settings.output_format = TEXT_OUTPUT;
+			else if (strcmp(argv[i], "json") == 0)
+				settings.output_format = JSON_OUTPUT;
+			else if (strcmp(argv[i], "csv") == 0)
+				settings.output_format = CSV_OUTPUT;
+			else
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+			settings.baseline_path = argv[++i];
+		else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%lf", &settings.regression_threshold) != 1
+			||  settings.regression_threshold < 0)
+				printUsageAndExit(argv);
+		}
+		else if (strncmp(argv[i], "--", 2) == 0 || nb_arguments == 4)
+			printUsageAndExit(argv);
+		else
+			arguments[nb_arguments++] = argv[i];
+	}
+
+	if (nb_arguments < 2)
 		printUsageAndExit(argv);
 
 	int nb_read_values = 0;
-	char* basepath = argv[1];
+	char* basepath = arguments[0];
 	int nb_graphs;
 
-	nb_read_values += sscanf(argv[2], "%d",  &nb_graphs);
+	nb_read_values += sscanf(arguments[1], "%d",  &nb_graphs);
+	if (nb_arguments > 2)
+		nb_read_values += sscanf(arguments[2], "%d",  &settings.delta);
+	if (nb_arguments > 3)
+		nb_read_values += sscanf(arguments[3], "%d",  &settings.nb_threads);
 
-	if (nb_read_values != 1)
+	if (nb_read_values != nb_arguments - 1)
 		printUsageAndExit(argv);
-	if (nb_graphs < 0)
+	if (nb_graphs < 0 || (nb_arguments > 3 && settings.nb_threads < 1))
 		printUsageAndExit(argv);
 
-	// Each graph is opened, algorithms are applied, and the performances are recorded
-	// Computed complexities
-	long connectivity_total_complexity 		= 0;
-	long naive_dijkstra_total_complexity    = 0;
-	long optimized_dijkstra_total_complexity = 0;
-
-	// Required time (in ms)
-	long connectivity_total_time 	  = 0;
-	long naive_dijkstra_total_time 	  = 0;
-	long optimized_dijkstra_total_time = 0;
+	// By default, the cores are shared between the workers
+	int nb_cores = getNbAvailableCores();
+	if (nb_arguments <= 3)
+		settings.nb_threads = nb_cores / settings.nb_workers < 1
+							? 1
+							: nb_cores / settings.nb_workers;
 
-	// Other interesting values
-	int nb_connected_graphs = 0;
+	// The baseline is read first, so that an invalid file is reported at once
+	Baseline* baseline = NULL;
+	if (settings.baseline_path != NULL)
+		baseline = readBaseline(settings.baseline_path);
 
-	// Precise time measurement structures
-	struct timespec start_time, end_time;
-	start_time.tv_sec  = 0;
-	start_time.tv_nsec = 0;
-	end_time.tv_sec    = 0;
-	end_time.tv_nsec   = 0;
+	// Benchmarked algorithms (the loading is only measured once per graph)
+	char delta_stepping_name[64];
+	snprintf(delta_stepping_name, sizeof(delta_stepping_name),
+			 "Delta-stepping (%d threads)", settings.nb_threads);
+	char afforest_name[64];
+	snprintf(afforest_name, sizeof(afforest_name),
+			 "Afforest (%d threads)", settings.nb_threads);
 
-	// Note: it is important to iterate from zero to n-1, given that graph paths are
-	// computed using this loop variable value!
-	bool is_connected;
-	int origin_vertex = 0;
+	BenchmarkedAlgorithm loading =
+		{ "Loading + connectivity", LOADING_ID, NULL, { NULL, 0, 0 }, 0, true, 0, 0 };
 
-	for (int i = 0; i < nb_graphs; i++)
+	BenchmarkedAlgorithm algorithms[NB_ALGORITHMS] =
 	{
-		// Get the current graph
-		Graph* graph = getGraphFromFile(basepath, i);
+		{ "Connectivity (union-find)", "connectivity", 	 runConnectivity,
+		  { NULL, 0, 0 }, 0, true,  0, 0 },
+		{ afforest_name, 			   "connectivity_afforest", runParallelConnectivity,
+		  { NULL, 0, 0 }, 0, false, 0, 0 },
+		{ "Naive Dijkstra", 		   "naive_dijkstra", runNaiveDijkstra,
+		  { NULL, 0, 0 }, 0, true,  0, 0 },
+		{ "Optimized Dijkstra", 	   "dijkstra", 		 runOptimizedDijkstra,
+		  { NULL, 0, 0 }, 0, false, 0, 0 },
+		{ delta_stepping_name, 		   "delta_stepping", runDeltaStepping,
+		  { NULL, 0, 0 }, 0, false, 0, 0 },
+		{ "Dense Dijkstra", 		   "dense_dijkstra", runDenseDijkstra,
+		  { NULL, 0, 0 }, 0, false, 0, 0 }
+	};
 
-		// Connectivity test
-		clock_gettime(CLOCK_REALTIME, &start_time);
-		is_connected = graphIsConnected(graph);
-		clock_gettime(CLOCK_REALTIME, &end_time);
+	// Each worker starts with empty measures
+	Batch batch;
+	batch.basepath 			 = basepath;
+	batch.nb_graphs 		 = nb_graphs;
+	batch.next_graph 		 = 0;
+	batch.settings 			 = &settings;
+	batch.nb_written_records = 0;
 
-		connectivity_total_time 	  += getTimeDifferenceInMs(&start_time, &end_time);
-		connectivity_total_complexity += COMPLEXITY;
+	batch.workers = calloc(settings.nb_workers, sizeof(BatchWorker));
+	CHECK_MALLOC(batch.workers);
 
-		if (is_connected)
-		{
-			nb_connected_graphs++;
+	for (int w = 0; w < settings.nb_workers; w++)
+	{
+		batch.workers[w].loading = loading;
+		memcpy(batch.workers[w].algorithms, algorithms, sizeof(algorithms));
+	}
 
-			// Naive Dijkstra's algorithm
-			clock_gettime(CLOCK_REALTIME, &start_time);
-			dijkstraNaive(graph, origin_vertex);
-			clock_gettime(CLOCK_REALTIME, &start_time);
+	// Each graph is opened, algorithms are applied, and the performances are recorded
+	// (graph paths are computed from the graph numbers, from zero to n-1)
+	writeRecordsHeader(settings.output_format);
 
-			naive_dijkstra_total_time 		+= getTimeDifferenceInMs(&start_time, &end_time);
-			naive_dijkstra_total_complexity += COMPLEXITY;
+	int64_t start_time = getCurrentTimeInNs();
+	runInParallel(settings.nb_workers, runBatchWorker, &batch);
+	int64_t sweep_time = getCurrentTimeInNs() - start_time;
 
+	writeRecordsFooter(settings.output_format, nb_graphs > 0);
 
-			// Optimized Dijkstra's algorithm
-			// clock_gettime(CLOCK_REALTIME, &start_time);
-			// dijkstra(graph, origin_vertex);
-			// clock_gettime(CLOCK_REALTIME, &start_time);
+	// The measures of all the workers are merged
+	long optimized_dijkstra_total_complexity = 0;
+	int nb_connected_graphs  = 0;
+	long total_nb_components = 0;
 
-			// optimized_dijkstra_total_time 	+= getTimeDifferenceInMs(&start_time, &end_time);
-			optimized_dijkstra_total_complexity += ComplexityOf_dijkstra(graph, origin_vertex);
-		}
+	for (int w = 0; w < settings.nb_workers; w++)
+	{
+		BatchWorker* worker = &batch.workers[w];
+
+		mergeBenchmarkedAlgorithm(&loading, &worker->loading);
+		for (int a = 0; a < NB_ALGORITHMS; a++)
+			mergeBenchmarkedAlgorithm(&algorithms[a], &worker->algorithms[a]);
+
+		optimized_dijkstra_total_complexity += worker->optimized_dijkstra_total_complexity;
+		nb_connected_graphs 				+= worker->nb_connected_graphs;
+		total_nb_components 				+= worker->total_nb_components;
 	}
 
 	// Average values to print
-	double average_connectivity_complexity =
-		(double) connectivity_total_complexity / (double) nb_graphs;
-	double average_naive_dijkstra_complexity =
-		(double) naive_dijkstra_total_complexity / (double) nb_connected_graphs;
+	double average_loading_complexity =
+		(double) loading.total_complexity / (double) nb_graphs;
 	double average_optimized_dijkstra_complexity =
 		(double) optimized_dijkstra_total_complexity / (double) nb_connected_graphs;
 
-	double average_connectivity_time =
-		(double) connectivity_total_time / (double) nb_graphs;
-	double average_naive_dijkstra_time =
-		(double) naive_dijkstra_total_time / (double) nb_connected_graphs;
-	double average_optimized_dijkstra_time =
-		(double) optimized_dijkstra_total_time / (double) nb_connected_graphs;
-
 	double connected_graphs_ratio = (double) nb_connected_graphs / (double) nb_graphs;
+	double average_nb_components  = (double) total_nb_components / (double) nb_graphs;
 
 	// Final printing
 	fprintf(stderr, "----- Results of batch testing on %d graphs -----\n", nb_graphs);
 	fprintf(stderr, "(Source path: %s)\n\n", basepath);
 
 	fprintf(stderr, "-- VARIOUS INFORMATION --\n");
-	fprintf(stderr, "Ratio of connected graphs: %lf\n\n", connected_graphs_ratio);
+	fprintf(stderr, "Ratio of connected graphs: %lf\n", connected_graphs_ratio);
+	fprintf(stderr, "Average number of components: %lf\n", average_nb_components);
+	fprintf(stderr, "Peak memory of the process (kB): %ld\n\n", getPeakMemoryInKb());
+
+	fprintf(stderr, "-- WORKERS (%d workers%s%s, %d cores) --\n", settings.nb_workers,
+		settings.pin_workers ? ", pinned" : "",
+		settings.prefetch_graphs ? ", prefetching" : "", nb_cores);
+	for (int w = 0; w < settings.nb_workers; w++)
+		fprintf(stderr, "Worker %d: %d graphs in %.4lf ms (loading %.4lf ms, waiting for graphs %.4lf ms)\n",
+			w,
+			batch.workers[w].nb_processed_graphs,
+			(double) batch.workers[w].busy_time / NB_NS_PER_MS,
+			(double) batch.workers[w].loading_time / NB_NS_PER_MS,
+			(double) batch.workers[w].waiting_time / NB_NS_PER_MS);
+	fprintf(stderr, "Wall-clock time of the sweep: %.4lf ms\n", (double) sweep_time / NB_NS_PER_MS);
+	if (settings.nb_workers * (settings.nb_threads + settings.prefetch_graphs) > nb_cores)
+		fprintf(stderr, "(More threads than cores: the times include their contention)\n");
+	fprintf(stderr, "\n");
 
 	fprintf(stderr, "-- AVERAGE COMPLEXITIES --\n");
-	fprintf(stderr, "Average connectivity test complexity: %lf\n",
-		average_connectivity_complexity);
-	fprintf(stderr, "Average naive Dijkstra complexity   : %lf\n",
-		average_naive_dijkstra_complexity);
+	fprintf(stderr, "Average loading + connectivity complexity: %lf\n",
+		average_loading_complexity);
+	for (int a = 0; a < NB_ALGORITHMS; a++)
+		if (algorithms[a].has_complexity)
+			fprintf(stderr, "Average %s complexity: %lf\n", algorithms[a].name,
+				(double) algorithms[a].total_complexity / (double) nb_connected_graphs);
 	fprintf(stderr, "Average optimized test complexity   : %lf\n\n",
 		average_optimized_dijkstra_complexity);
 
-	fprintf(stderr, "-- AVERAGE EXEC TIMES (milliseconds) --\n");
-	fprintf(stderr, "Average connectivity test time: %lf\n",
-		average_connectivity_time);
-	fprintf(stderr, "Average naive Dijkstra time   : %lf\n",
-		average_naive_dijkstra_time);
-	fprintf(stderr, "Average optimized test time   : %lf\n",
-		average_optimized_dijkstra_time);
+	bool has_regression = false;
+	if (baseline != NULL)
+	{
+		fprintf(stderr, "-- COMPARISON TO THE BASELINE (average median times, threshold %.2lf%%) --\n",
+			settings.regression_threshold);
+
+		has_regression |= compareToBaseline(&loading, baseline, settings.regression_threshold);
+		for (int a = 0; a < NB_ALGORITHMS; a++)
+			has_regression |= compareToBaseline(&algorithms[a], baseline,
+												settings.regression_threshold);
+		fprintf(stderr, "\n");
+
+		freeBaseline(baseline);
+	}
+
+	fprintf(stderr, "-- EXEC TIMES (milliseconds, %d warm-up runs, %d measured runs per graph) --\n",
+		settings.nb_warmup_runs, settings.nb_repetitions);
+	printTimeStatistics(loading.name, &loading.samples);
+	for (int a = 0; a < NB_ALGORITHMS; a++)
+		printTimeStatistics(algorithms[a].name, &algorithms[a].samples);
 
-	fprintf(stderr, "\n(Test) Value of COMPLEXITY variable: %ld\n", COMPLEXITY);
+	for (int a = 0; a < NB_ALGORITHMS; a++)
+		free(algorithms[a].samples.values);
+	free(loading.samples.values);
+	free(batch.workers);
 
-	return 0; 
+	return has_regression ? REGRESSION_EXIT_CODE : 0;
 }
@@ -18,33 +18,24 @@
 //------------------------------------------------------------------------------
 
 // Declaration and initialization of the global complexity variable
-unsigned long COMPLEXITY = 0;
+// (one per thread, so that concurrent computations do not mix their counts)
+__thread unsigned long COMPLEXITY = 0;
 
 //------------------------------------------------------------------------------
 // FUNCTIONS FROM FILE "list.c"
 //------------------------------------------------------------------------------
 
-int ComplexityOf_createList () { return 4; }
-int ComplexityOf_listIsEmpty () { return 2; }
-int ComplexityOf_addElementToList () { return 5; }
-int ComplexityOf_popFromList () { return 3; }
+int ComplexityOf_createStack () { return 5; }
+int ComplexityOf_stackIsEmpty () { return 2; }
+int ComplexityOf_pushToStack () { return 4; } // Amortized
+int ComplexityOf_popFromStack () { return 3; }
+int ComplexityOf_concatTwoStacks (Stack* stack_1, Stack* stack_2) { return 4 + stack_2->size; }
 
-int ComplexityOf_concatTwoLists (List* L1 ,List* L2)
-{
-	int complexity 		  = 0;
-	ListElt* list_element = L2->first;
-
-	while (list_element != NULL)
-	{
-		complexity += ComplexityOf_listIsEmpty();
-		complexity += ComplexityOf_popFromList();
-		complexity += 1;
-		complexity += ComplexityOf_addElementToList();
-		list_element = list_element->next;
-	}	
-
-	return complexity;
-}
+int ComplexityOf_createQueue () { return 6; }
+int ComplexityOf_queueIsEmpty () { return 2; }
+int ComplexityOf_pushBackToQueue () { return 5; } // Amortized
+int ComplexityOf_pushFrontToQueue () { return 5; } // Amortized
+int ComplexityOf_popFrontFromQueue () { return 5; }
 
 //------------------------------------------------------------------------------
 // FUNCTIONS FROM FILE "graph.c"
@@ -71,18 +62,23 @@ int numberOfEdges (Graph* g)
 	return res/2;
 }
 
-int ComplexityOf_graphIsConnected (Graph* g) 
+// Union-find: the amortized cost of a find is considered as constant
+int ComplexityOf_graphIsConnected (Graph* g)
 {
 	int res = 0;
 	int S = g->nb_vertexes;
 	int A = numberOfEdges(g);
-	res = 2+3*S
-		+2*A*(3+ComplexityOf_popFromList()+
-			  ComplexityOf_addElementToList())
-		+S*2
-		+1+S;
+	res = 2*S
+		+2*A*2
+		+A*(2*ComplexityOf_findSetRoot()+5);
 	return res;
-}                                                                                            
+}
+
+//------------------------------------------------------------------------------
+// FUNCTIONS FROM FILE "connectivity.c"
+//------------------------------------------------------------------------------
+
+int ComplexityOf_findSetRoot () { return 4; }
 
 //------------------------------------------------------------------------------
 // FUNCTIONS FROM FILE "fibonacci_heap.c"
@@ -328,7 +324,7 @@ int ComplexityOf_decreaseKeyInFiboHeap (FiboHeap* fibo_heap, Node* node, int new
 // FUNCTIONS FROM FILE "dijkstra.c"
 //------------------------------------------------------------------------------
 
-int ComplexityOf_extractMinimumNaive (bool*seen, int*lengths, int nb_vertexes)
+int ComplexityOf_extractMinimumNaive (int nb_vertexes)
 {
 	int res = 0;
 	int S = nb_vertexes;
@@ -343,7 +339,7 @@ int ComplexityOf_dijkstraNaive (Graph* g, int s) // O(#A²)
 	int A = numberOfEdges(g);
 	res = S*2
 		+2
-		+S*(ComplexityOf_extractMinimumNaive(NULL,NULL,S)+4)
+		+S*(ComplexityOf_extractMinimumNaive(S)+4)
 		+2*A*(5);
 	return res;
 }
@@ -389,3 +385,20 @@ int ComplexityOf_dijkstra (Graph* g, int s)
 
 	return complexity;
 }
+
+//------------------------------------------------------------------------------
+// FUNCTIONS FROM FILE "small_weight_sssp.c"
+//------------------------------------------------------------------------------
+
+// Upper bound: a vertex is pushed at most once per edge end improving it
+int ComplexityOf_zeroOneBFS (Graph* g, int s) // O(#S + #A)
+{
+	int res = 0;
+	int S = g->nb_vertexes;
+	int A = numberOfEdges(g);
+	res = S*3
+		+3
+		+(1 + 2*A)*(ComplexityOf_pushBackToQueue()+ComplexityOf_popFrontFromQueue()+2)
+		+2*A*(5);
+	return res;
+}
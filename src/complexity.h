@@ -11,14 +11,21 @@
 #include "dijkstra.h"
 
 // Global variable which should be used as an accumulator for complexity computation
-extern unsigned long COMPLEXITY;
+// (thread-local: each thread accumulates the complexity of its own computations)
+extern __thread unsigned long COMPLEXITY;
 
 // Functions from file "list.c"
-int ComplexityOf_createList ();
-int ComplexityOf_listIsEmpty ();
-int ComplexityOf_addElementToList ();
-int ComplexityOf_popFromList ();
-int ComplexityOf_concatTwoLists (List* L1, List* L2);
+int ComplexityOf_createStack ();
+int ComplexityOf_stackIsEmpty ();
+int ComplexityOf_pushToStack ();
+int ComplexityOf_popFromStack ();
+int ComplexityOf_concatTwoStacks (Stack* stack_1, Stack* stack_2);
+
+int ComplexityOf_createQueue ();
+int ComplexityOf_queueIsEmpty ();
+int ComplexityOf_pushBackToQueue ();
+int ComplexityOf_pushFrontToQueue ();
+int ComplexityOf_popFrontFromQueue ();
 
 // Functions from file "graph.c"
 int ComplexityOf_createEdge ();
@@ -27,6 +34,9 @@ int ComplexityOf_addUndirectedEdgeToGraph ();
 int ComplexityOf_createGraphFromFile ();
 int ComplexityOf_graphIsConnected (Graph* g);
 
+// Functions from file "connectivity.c"
+int ComplexityOf_findSetRoot ();
+
 // Functions from file "fibonacci_heap.c"
 int ComplexityOf_createNode (NodeValue value, int key);
 int ComplexityOf_createIsolatedNode (NodeValue value, int key);
@@ -51,8 +61,11 @@ int ComplexityOf_recursiveCutsInFiboHeap (FiboHeap* fibo_heap, Node* node_to_cut
 int ComplexityOf_decreaseKeyInFiboHeap (FiboHeap* fibo_heap, Node* node, int new_key);
 
 // Functions from file "dijkstra.c"
-int ComplexityOf_extractMinimumNaive (bool* seen, int* lengths, int nb_vertexes);
+int ComplexityOf_extractMinimumNaive (int nb_vertexes);
 int ComplexityOf_dijkstraNaive (Graph* g, int s);
 int ComplexityOf_dijkstra (Graph* g, int s);
 
+// Functions from file "small_weight_sssp.c"
+int ComplexityOf_zeroOneBFS (Graph* g, int s);
+
 #endif
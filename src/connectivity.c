@@ -0,0 +1,415 @@
+//------------------------------------------------------------------------------
+// CONNECTIVITY
+//------------------------------------------------------------------------------
+// Connected components with a union-find structure (union by rank and path
+// compression): every edge merges the sets of its two ends, which costs an
+// almost constant amortized time, without any auxiliary list or queue.
+// O(#S + #A * alpha(#S)), with a memory of O(#S).
+//
+// The parallel version follows Afforest (Sutton et al.): the trees of the
+// forest are linked with atomic compare-and-swap operations (a root is always
+// hooked to a smaller vertex). A few neighbours of every vertex are first
+// linked, which usually builds a giant component; after a sampling step, the
+// vertexes of this component can skip the rest of their neighbours.
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "toolbox.h"
+#include "complexity.h"
+#include "graph.h"
+#include "parallel.h"
+#include "connectivity.h"
+
+// Number of neighbours linked before the sampling of the largest component
+#define NB_NEIGHBOUR_ROUNDS 2
+
+// Number of vertexes sampled to find the largest component
+#define NB_COMPONENT_SAMPLES 1024
+
+//------------------------------------------------------------------------------
+// UNION-FIND
+//------------------------------------------------------------------------------
+
+// Every element is alone in its set
+UnionFind* createUnionFind (int nb_elements)
+{
+	UnionFind* union_find = malloc(sizeof(UnionFind));
+	CHECK_MALLOC(union_find);
+
+	union_find->nb_elements = nb_elements;
+	union_find->nb_sets 	= nb_elements;
+	union_find->parents 	= malloc((nb_elements + 1) * sizeof(int));
+	union_find->ranks 		= calloc(nb_elements + 1, sizeof(unsigned char));
+	CHECK_MALLOC(union_find->parents);
+	CHECK_MALLOC(union_find->ranks);
+
+	for (int i = 0; i < nb_elements; i++)
+	{
+		union_find->parents[i] = i;
+		COMPLEXITY += 2;
+	}
+
+	return union_find;
+}
+
+void freeUnionFind (UnionFind* union_find)
+{
+	free(union_find->parents);
+	free(union_find->ranks);
+
+	free(union_find);
+}
+
+// Root of the set of the element; the path to the root is compressed
+// (every element of the path becomes a child of the root)
+int findSetRoot (UnionFind* union_find, int element)
+{
+	int* parents = union_find->parents;
+
+	int root = element;
+	while (parents[root] != root)
+	{
+		root = parents[root];
+		COMPLEXITY += 2;
+	}
+
+	while (parents[element] != root)
+	{
+		int next_element = parents[element];
+		parents[element] = root;
+		element = next_element;
+		COMPLEXITY += 3;
+	}
+
+	COMPLEXITY += 2;
+	return root;
+}
+
+// Union by rank: the root of lower rank becomes a child of the other one
+// Returns false if both elements were already in the same set
+bool mergeSets (UnionFind* union_find, int element_1, int element_2)
+{
+	int root_1 = findSetRoot(union_find, element_1);
+	int root_2 = findSetRoot(union_find, element_2);
+
+	COMPLEXITY++;
+	if (root_1 == root_2)
+		return false;
+
+	unsigned char* ranks = union_find->ranks;
+
+	if (ranks[root_1] < ranks[root_2])
+		union_find->parents[root_1] = root_2;
+	else if (ranks[root_1] > ranks[root_2])
+		union_find->parents[root_2] = root_1;
+	else
+	{
+		union_find->parents[root_2] = root_1;
+		(ranks[root_1])++;
+	}
+
+	(union_find->nb_sets)--;
+	COMPLEXITY += 4;
+
+	return true;
+}
+
+// Merge the ends of every edge (each undirected edge is stored twice, but
+// only merged once)
+void mergeGraphEdges (UnionFind* union_find, Graph* g)
+{
+	for (int i = 0; i < g->nb_vertexes; i++)
+		for (Edge* edge = g->edges[i]; edge != NULL; edge = edge->next)
+		{
+			COMPLEXITY += 2;
+			if (edge->destination > i)
+				mergeSets(union_find, i, edge->destination);
+		}
+}
+
+//------------------------------------------------------------------------------
+// CONNECTED COMPONENTS
+//------------------------------------------------------------------------------
+
+int countConnectedComponents (Graph* g)
+{
+	UnionFind* union_find = createUnionFind(g->nb_vertexes);
+	mergeGraphEdges(union_find, g);
+
+	int nb_components = union_find->nb_sets;
+	freeUnionFind(union_find);
+
+	return nb_components;
+}
+
+// Build the labels from the representative of each vertex (which must be
+// the same for all the vertexes of a component, and belong to it)
+// Labels are given in order of the smallest vertex of each component
+Components* createComponentsFromRoots (int nb_vertexes, int* roots)
+{
+	Components* components = malloc(sizeof(Components));
+	CHECK_MALLOC(components);
+
+	components->nb_vertexes   = nb_vertexes;
+	components->nb_components = 0;
+	components->labels 		  = malloc((nb_vertexes + 1) * sizeof(int));
+	components->sizes 		  = calloc(nb_vertexes + 1, sizeof(int));
+	CHECK_MALLOC(components->labels);
+	CHECK_MALLOC(components->sizes);
+
+	int* root_labels = malloc((nb_vertexes + 1) * sizeof(int));
+	CHECK_MALLOC(root_labels);
+
+	for (int i = 0; i < nb_vertexes; i++)
+		root_labels[i] = -1;
+
+	for (int i = 0; i < nb_vertexes; i++)
+	{
+		int root = roots[i];
+
+		if (root_labels[root] == -1)
+		{
+			root_labels[root] = components->nb_components;
+			(components->nb_components)++;
+		}
+
+		components->labels[i] = root_labels[root];
+		(components->sizes[root_labels[root]])++;
+	}
+
+	free(root_labels);
+	return components;
+}
+
+Components* computeConnectedComponents (Graph* g)
+{
+	UnionFind* union_find = createUnionFind(g->nb_vertexes);
+	mergeGraphEdges(union_find, g);
+
+	// Once compressed, the parent of every vertex is its root
+	for (int i = 0; i < g->nb_vertexes; i++)
+		findSetRoot(union_find, i);
+
+	Components* components = createComponentsFromRoots(g->nb_vertexes, union_find->parents);
+
+	freeUnionFind(union_find);
+	return components;
+}
+
+void freeComponents (Components* components)
+{
+	free(components->labels);
+	free(components->sizes);
+	free(components);
+}
+
+// Number of components of each size class: class k gathers the components
+// whose size is between 2^k and 2^(k+1) - 1
+int* computeComponentSizeHistogram (Components* components, int* nb_size_classes)
+{
+	*nb_size_classes = 1;
+	while (*nb_size_classes < 31 && (1 << *nb_size_classes) <= components->nb_vertexes)
+		(*nb_size_classes)++;
+
+	int* histogram = calloc(*nb_size_classes, sizeof(int));
+	CHECK_MALLOC(histogram);
+
+	for (int c = 0; c < components->nb_components; c++)
+	{
+		int size_class = 0;
+		while ((components->sizes[c] >> (size_class + 1)) > 0)
+			size_class++;
+
+		(histogram[size_class])++;
+	}
+
+	return histogram;
+}
+
+//------------------------------------------------------------------------------
+// PARALLEL CONNECTED COMPONENTS (AFFOREST)
+//------------------------------------------------------------------------------
+
+// Merge the trees of two vertexes: the larger root is hooked to the smaller
+// one, unless another thread changed it in the meantime (then retry)
+void linkVertexesAtomically (int* parents, int vertex_1, int vertex_2)
+{
+	int parent_1 = __atomic_load_n(&parents[vertex_1], __ATOMIC_RELAXED);
+	int parent_2 = __atomic_load_n(&parents[vertex_2], __ATOMIC_RELAXED);
+
+	while (parent_1 != parent_2)
+	{
+		int high = parent_1 > parent_2 ? parent_1 : parent_2;
+		int low  = parent_1 > parent_2 ? parent_2 : parent_1;
+
+		int parent_high = __atomic_load_n(&parents[high], __ATOMIC_RELAXED);
+		if (parent_high == low)
+			break;
+
+		if (parent_high == high
+		&&  __atomic_compare_exchange_n(&parents[high], &parent_high, low,
+										false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			break;
+
+		parent_1 = __atomic_load_n(&parents[__atomic_load_n(&parents[high], __ATOMIC_RELAXED)],
+								   __ATOMIC_RELAXED);
+		parent_2 = __atomic_load_n(&parents[low], __ATOMIC_RELAXED);
+	}
+}
+
+// Make the vertex point to the root of its tree (pointer jumping)
+void compressPathAtomically (int* parents, int vertex)
+{
+	int parent = __atomic_load_n(&parents[vertex], __ATOMIC_RELAXED);
+	int grand_parent = __atomic_load_n(&parents[parent], __ATOMIC_RELAXED);
+
+	while (parent != grand_parent)
+	{
+		__atomic_store_n(&parents[vertex], grand_parent, __ATOMIC_RELAXED);
+		parent = grand_parent;
+		grand_parent = __atomic_load_n(&parents[parent], __ATOMIC_RELAXED);
+	}
+}
+
+// Link every vertex (of this thread's range) to its neighbour of the round
+void runNeighbourRound (int thread_num, int nb_threads, void* argument)
+{
+	AfforestState* state = argument;
+	Graph* g = state->graph;
+
+	int start = (int) (((long) g->nb_vertexes * thread_num) / nb_threads);
+	int end   = (int) (((long) g->nb_vertexes * (thread_num + 1)) / nb_threads);
+
+	for (int i = start; i < end; i++)
+	{
+		Edge* edge = g->edges[i];
+		for (int r = 0; r < state->neighbour_round && edge != NULL; r++)
+			edge = edge->next;
+
+		if (edge != NULL)
+			linkVertexesAtomically(state->parents, i, edge->destination);
+	}
+}
+
+void runPathCompression (int thread_num, int nb_threads, void* argument)
+{
+	AfforestState* state = argument;
+	int nb_vertexes = state->graph->nb_vertexes;
+
+	int start = (int) (((long) nb_vertexes * thread_num) / nb_threads);
+	int end   = (int) (((long) nb_vertexes * (thread_num + 1)) / nb_threads);
+
+	for (int i = start; i < end; i++)
+		compressPathAtomically(state->parents, i);
+}
+
+// Link the remaining neighbours of the vertexes out of the largest component
+// (an edge between two components is seen from both of its ends, so the
+// largest one can be skipped)
+void runRemainingLinks (int thread_num, int nb_threads, void* argument)
+{
+	AfforestState* state = argument;
+	Graph* g = state->graph;
+
+	int start = (int) (((long) g->nb_vertexes * thread_num) / nb_threads);
+	int end   = (int) (((long) g->nb_vertexes * (thread_num + 1)) / nb_threads);
+
+	for (int i = start; i < end; i++)
+	{
+		if (__atomic_load_n(&state->parents[i], __ATOMIC_RELAXED) == state->largest_component)
+			continue;
+
+		Edge* edge = g->edges[i];
+		for (int r = 0; r < NB_NEIGHBOUR_ROUNDS && edge != NULL; r++)
+			edge = edge->next;
+
+		for (; edge != NULL; edge = edge->next)
+			linkVertexesAtomically(state->parents, i, edge->destination);
+	}
+}
+
+// Most frequent root among a sample of vertexes (the forest must be compressed)
+int findLargestSampledComponent (int* parents, int nb_vertexes)
+{
+	int samples[NB_COMPONENT_SAMPLES];
+	unsigned int random_state = 0x9E3779B9u;
+
+	for (int i = 0; i < NB_COMPONENT_SAMPLES; i++)
+	{
+		// Xorshift (any sequence spread over the vertexes is fine)
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+
+		samples[i] = parents[random_state % (unsigned int) nb_vertexes];
+	}
+
+	// The most frequent value of the sorted samples
+	qsort(samples, NB_COMPONENT_SAMPLES, sizeof(int), compareIntegers);
+
+	int largest_component = samples[0];
+	int max_count = 0;
+	int count = 0;
+
+	for (int i = 0; i < NB_COMPONENT_SAMPLES; i++)
+	{
+		count = (i > 0 && samples[i] == samples[i - 1]) ? count + 1 : 1;
+
+		if (count > max_count)
+		{
+			max_count = count;
+			largest_component = samples[i];
+		}
+	}
+
+	return largest_component;
+}
+
+int compareIntegers (const void* integer_1, const void* integer_2)
+{
+	int value_1 = *(const int*) integer_1;
+	int value_2 = *(const int*) integer_2;
+
+	return (value_1 > value_2) - (value_1 < value_2);
+}
+
+// Same result as computeConnectedComponents()
+// A null or negative number of threads selects a default value
+Components* computeConnectedComponentsInParallel (Graph* g, int nb_threads)
+{
+	if (nb_threads <= 0)
+		nb_threads = getNbAvailableCores();
+
+	AfforestState state;
+	state.graph 			= g;
+	state.largest_component = -1;
+	state.parents 			= malloc((g->nb_vertexes + 1) * sizeof(int));
+	CHECK_MALLOC(state.parents);
+
+	for (int i = 0; i < g->nb_vertexes; i++)
+		state.parents[i] = i;
+
+	// 1. Links to the first neighbours
+	for (int r = 0; r < NB_NEIGHBOUR_ROUNDS; r++)
+	{
+		state.neighbour_round = r;
+		runInParallel(nb_threads, runNeighbourRound, &state);
+		runInParallel(nb_threads, runPathCompression, &state);
+	}
+
+	// 2. Links to the other neighbours, except inside the largest component
+	if (g->nb_vertexes > 0)
+		state.largest_component = findLargestSampledComponent(state.parents, g->nb_vertexes);
+
+	runInParallel(nb_threads, runRemainingLinks, &state);
+	runInParallel(nb_threads, runPathCompression, &state);
+
+	// Roots are the smallest vertexes of their trees, as in the sequential version
+	Components* components = createComponentsFromRoots(g->nb_vertexes, state.parents);
+
+	free(state.parents);
+	return components;
+}
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+// CONNECTIVITY
+//------------------------------------------------------------------------------
+
+#ifndef _CONNECTIVITY_H
+#define _CONNECTIVITY_H
+
+#include <stdbool.h>
+#include "graph.h"
+
+// Disjoint sets of vertexes (union-find forest)
+typedef struct UnionFind
+{
+	int nb_elements;
+	int nb_sets;
+	int* parents; // A root is its own parent
+	unsigned char* ranks; // Upper bound of the height of a root's tree
+} UnionFind;
+
+// Connected components of a graph: labels are between 0 and nb_components - 1,
+// numbered by increasing smallest vertex
+typedef struct Components
+{
+	int nb_vertexes;
+	int nb_components;
+	int* labels;
+	int* sizes; // Number of vertexes of each component
+} Components;
+
+// Work shared by the threads of the parallel labeling
+typedef struct AfforestState
+{
+	Graph* graph;
+	int* parents; // Updated atomically
+	int neighbour_round;
+	int largest_component; // Root of the largest sampled component
+} AfforestState;
+
+//------------------------------------------------------------------------------
+
+UnionFind* createUnionFind (int nb_elements);
+void freeUnionFind (UnionFind* union_find);
+int findSetRoot (UnionFind* union_find, int element);
+bool mergeSets (UnionFind* union_find, int element_1, int element_2);
+void mergeGraphEdges (UnionFind* union_find, Graph* g);
+
+int countConnectedComponents (Graph* g);
+Components* createComponentsFromRoots (int nb_vertexes, int* roots);
+Components* computeConnectedComponents (Graph* g);
+void freeComponents (Components* components);
+int* computeComponentSizeHistogram (Components* components, int* nb_size_classes);
+
+void linkVertexesAtomically (int* parents, int vertex_1, int vertex_2);
+void compressPathAtomically (int* parents, int vertex);
+void runNeighbourRound (int thread_num, int nb_threads, void* state);
+void runPathCompression (int thread_num, int nb_threads, void* state);
+void runRemainingLinks (int thread_num, int nb_threads, void* state);
+int compareIntegers (const void* integer_1, const void* integer_2);
+int findLargestSampledComponent (int* parents, int nb_vertexes);
+Components* computeConnectedComponentsInParallel (Graph* g, int nb_threads);
+
+#endif
@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+// DELTA-STEPPING
+//------------------------------------------------------------------------------
+// Parallel single-source shortest paths (Meyer & Sanders' delta-stepping).
+// Vertexes are grouped in buckets of width delta according to their tentative
+// distance. The buckets are processed in order; inside a bucket, light edges
+// (weight <= delta) are relaxed in parallel rounds until the bucket is empty,
+// then heavy edges of all the vertexes settled in this bucket are relaxed.
+//
+// Each thread owns its own (cyclic) buckets, in which it inserts the vertexes
+// whose distance it improved. A vertex can thus appear in several buckets:
+// outdated entries are skipped when a bucket is emptied.
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include "toolbox.h"
+#include "list.h"
+#include "graph.h"
+#include "dijkstra.h"
+#include "parallel.h"
+#include "delta_stepping.h"
+
+// Distance of a vertex which has not been reached yet
+#define UNREACHED_DISTANCE UINT_MAX
+
+// State shared by all the threads of a delta-stepping run
+struct DeltaSteppingState
+{
+	Graph* graph;
+	int delta;
+	int nb_buckets; // Buckets are used cyclically
+
+	// Tentative distances (UINT_MAX if the vertex has not been reached)
+	unsigned int* distances;
+
+	// Number of the last round in which each vertex has been claimed,
+	// and number of the last bucket (+1) in which it has been settled
+	unsigned int* claim_rounds;
+	unsigned int* settled_buckets;
+
+	// Per-thread data (buckets are stacks of vertexes)
+	Stack** buckets; 	   // buckets[thread][bucket]
+	Stack* local_frontiers;
+	Stack* local_settled;
+	int* next_bucket_offsets;
+
+	// Frontier of the current round (union of all the local frontiers)
+	int* frontier;
+
+	unsigned int current_bucket;
+	unsigned int current_round;
+
+	pthread_barrier_t barrier;
+};
+
+//------------------------------------------------------------------------------
+// DELTA
+//------------------------------------------------------------------------------
+
+// Heuristic value of delta: (max weight) / (average degree), at least 1
+int computeDefaultDelta (Graph* g)
+{
+	long nb_edge_ends = 0;
+	int max_weight 	  = 0;
+
+	for (int i = 0; i < g->nb_vertexes; i++)
+		for (Edge* edge = g->edges[i]; edge != NULL; edge = edge->next)
+		{
+			nb_edge_ends++;
+			if (edge->weight > max_weight)
+				max_weight = edge->weight;
+		}
+
+	if (nb_edge_ends == 0)
+		return 1;
+
+	double average_degree = (double) nb_edge_ends / (double) g->nb_vertexes;
+	int delta = (int) ((double) max_weight / average_degree);
+
+	return delta < 1 ? 1 : delta;
+}
+
+//------------------------------------------------------------------------------
+// PARALLEL PHASES
+//------------------------------------------------------------------------------
+
+// Relax either the light or the heavy edges of a vertex
+void relaxEdgesInParallel (DeltaSteppingState* state, int thread_num,
+						   int vertex, bool light_edges)
+{
+	unsigned int distance = __atomic_load_n(&state->distances[vertex], __ATOMIC_RELAXED);
+	Stack* buckets = state->buckets[thread_num];
+
+	for (Edge* edge = state->graph->edges[vertex]; edge != NULL; edge = edge->next)
+	{
+		if ((edge->weight <= state->delta) != light_edges)
+			continue;
+
+		unsigned int new_distance = distance + edge->weight;
+		if (atomicMinUnsigned(&state->distances[edge->destination], new_distance))
+		{
+			int bucket = (new_distance / state->delta) % state->nb_buckets;
+			pushToStack(&buckets[bucket], edge->destination);
+		}
+	}
+}
+
+// Empty the current bucket of every thread into the shared frontier
+// Each vertex is claimed by a single thread, and only if it still belongs to
+// the current bucket; the vertexes claimed for the first time in this bucket
+// are also recorded for the heavy edges phase
+void buildFrontierInParallel (DeltaSteppingState* state, int thread_num)
+{
+	unsigned int current_bucket = state->current_bucket;
+	unsigned int current_round  = state->current_round;
+
+	Stack* bucket = &state->buckets[thread_num][current_bucket % state->nb_buckets];
+	Stack* local_frontier = &state->local_frontiers[thread_num];
+	Stack* local_settled  = &state->local_settled[thread_num];
+
+	local_frontier->size = 0;
+
+	for (int i = 0; i < bucket->size; i++)
+	{
+		int vertex = bucket->elements[i];
+
+		// Outdated entry (the vertex has moved to a smaller bucket)
+		unsigned int distance = __atomic_load_n(&state->distances[vertex], __ATOMIC_RELAXED);
+		if (distance / state->delta != current_bucket)
+			continue;
+
+		// Claim the vertex for this round (unless another thread already did it)
+		unsigned int last_round = __atomic_load_n(&state->claim_rounds[vertex], __ATOMIC_RELAXED);
+		if (last_round == current_round
+		|| !__atomic_compare_exchange_n(&state->claim_rounds[vertex], &last_round, current_round,
+										false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			continue;
+
+		pushToStack(local_frontier, vertex);
+
+		if (state->settled_buckets[vertex] != current_bucket + 1)
+		{
+			state->settled_buckets[vertex] = current_bucket + 1;
+			pushToStack(local_settled, vertex);
+		}
+	}
+	bucket->size = 0;
+
+	pthread_barrier_wait(&state->barrier);
+
+	// Copy the local frontier at the right place of the shared frontier
+	int offset = 0;
+	for (int t = 0; t < thread_num; t++)
+		offset += state->local_frontiers[t].size;
+
+	for (int i = 0; i < local_frontier->size; i++)
+		state->frontier[offset + i] = local_frontier->elements[i];
+
+	pthread_barrier_wait(&state->barrier);
+}
+
+void runDeltaSteppingThread (int thread_num, int nb_threads, void* argument)
+{
+	DeltaSteppingState* state = argument;
+
+	while (true)
+	{
+		// 1. Light edges: rounds are repeated until the current bucket stays empty
+		while (true)
+		{
+			buildFrontierInParallel(state, thread_num);
+
+			int frontier_size = 0;
+			for (int t = 0; t < nb_threads; t++)
+				frontier_size += state->local_frontiers[t].size;
+
+			// The round counter is shared: all threads must have read it before
+			pthread_barrier_wait(&state->barrier);
+			if (thread_num == 0)
+				(state->current_round)++;
+
+			if (frontier_size == 0)
+				break;
+
+			int start = (int) (((long) frontier_size * thread_num) / nb_threads);
+			int end   = (int) (((long) frontier_size * (thread_num + 1)) / nb_threads);
+
+			for (int i = start; i < end; i++)
+				relaxEdgesInParallel(state, thread_num, state->frontier[i], true);
+
+			pthread_barrier_wait(&state->barrier);
+		}
+
+		// 2. Heavy edges of the vertexes settled in the current bucket
+		Stack* local_settled = &state->local_settled[thread_num];
+		for (int i = 0; i < local_settled->size; i++)
+			relaxEdgesInParallel(state, thread_num, local_settled->elements[i], false);
+		local_settled->size = 0;
+
+		// 3. Find the next non-empty bucket (among all the threads' buckets)
+		int next_offset = state->nb_buckets;
+		for (int k = 1; k < state->nb_buckets; k++)
+		{
+			int bucket = (state->current_bucket + k) % state->nb_buckets;
+			if (state->buckets[thread_num][bucket].size > 0)
+			{
+				next_offset = k;
+				break;
+			}
+		}
+		state->next_bucket_offsets[thread_num] = next_offset;
+
+		pthread_barrier_wait(&state->barrier);
+
+		for (int t = 0; t < nb_threads; t++)
+			if (state->next_bucket_offsets[t] < next_offset)
+				next_offset = state->next_bucket_offsets[t];
+
+		pthread_barrier_wait(&state->barrier);
+
+		if (next_offset == state->nb_buckets)
+			break;
+
+		if (thread_num == 0)
+			state->current_bucket += next_offset;
+
+		pthread_barrier_wait(&state->barrier);
+	}
+}
+
+//------------------------------------------------------------------------------
+// DELTA-STEPPING
+//------------------------------------------------------------------------------
+
+// A null or negative delta (resp. number of threads) selects a default value
+// The returned lengths follow the conventions of dijkstraNaive()
+int* deltaStepping (Graph* g, int s, int delta, int nb_threads)
+{
+	int nb_vertexes = g->nb_vertexes;
+
+	if (delta <= 0)
+		delta = computeDefaultDelta(g);
+	if (nb_threads <= 0)
+		nb_threads = getNbAvailableCores();
+
+	// Initialization of the shared state
+	DeltaSteppingState state;
+	state.graph 		 = g;
+	state.delta 		 = delta;
+	state.current_bucket = 0;
+	state.current_round  = 1;
+
+	// A relaxation can only reach (max weight / delta + 1) buckets ahead
+	int max_weight = 0;
+	for (int i = 0; i < nb_vertexes; i++)
+		for (Edge* edge = g->edges[i]; edge != NULL; edge = edge->next)
+			if (edge->weight > max_weight)
+				max_weight = edge->weight;
+
+	state.nb_buckets = max_weight / delta + 2;
+
+	state.distances 	  = malloc(nb_vertexes * sizeof(unsigned int));
+	state.claim_rounds 	  = malloc(nb_vertexes * sizeof(unsigned int));
+	state.settled_buckets = malloc(nb_vertexes * sizeof(unsigned int));
+	state.frontier 		  = malloc(nb_vertexes * sizeof(int));
+	CHECK_MALLOC(state.distances);
+	CHECK_MALLOC(state.claim_rounds);
+	CHECK_MALLOC(state.settled_buckets);
+	CHECK_MALLOC(state.frontier);
+
+	for (int i = 0; i < nb_vertexes; i++)
+	{
+		state.distances[i] 		 = UNREACHED_DISTANCE;
+		state.claim_rounds[i] 	 = 0;
+		state.settled_buckets[i] = 0;
+	}
+
+	state.buckets 			  = malloc(nb_threads * sizeof(Stack*));
+	state.local_frontiers 	  = calloc(nb_threads, sizeof(Stack));
+	state.local_settled 	  = calloc(nb_threads, sizeof(Stack));
+	state.next_bucket_offsets = malloc(nb_threads * sizeof(int));
+	CHECK_MALLOC(state.buckets);
+	CHECK_MALLOC(state.local_frontiers);
+	CHECK_MALLOC(state.local_settled);
+	CHECK_MALLOC(state.next_bucket_offsets);
+
+	for (int t = 0; t < nb_threads; t++)
+	{
+		state.buckets[t] = calloc(state.nb_buckets, sizeof(Stack));
+		CHECK_MALLOC(state.buckets[t]);
+	}
+
+	pthread_barrier_init(&state.barrier, NULL, nb_threads);
+
+	// The origin is the only vertex of the first bucket
+	state.distances[s] = 0;
+	pushToStack(&state.buckets[0][0], s);
+
+	// Main loop (run by all the threads)
+	runInParallel(nb_threads, runDeltaSteppingThread, &state);
+
+	// Conversion of the distances to lengths
+	int* lengths = malloc(nb_vertexes * sizeof(int));
+	CHECK_MALLOC(lengths);
+
+	for (int i = 0; i < nb_vertexes; i++)
+		lengths[i] = state.distances[i] == UNREACHED_DISTANCE
+				   ? INF_LENGTH
+				   : (int) state.distances[i];
+
+	// Cleaning
+	pthread_barrier_destroy(&state.barrier);
+
+	for (int t = 0; t < nb_threads; t++)
+	{
+		for (int b = 0; b < state.nb_buckets; b++)
+			freeStackContent(&state.buckets[t][b]);
+		free(state.buckets[t]);
+		freeStackContent(&state.local_frontiers[t]);
+		freeStackContent(&state.local_settled[t]);
+	}
+
+	free(state.buckets);
+	free(state.local_frontiers);
+	free(state.local_settled);
+	free(state.next_bucket_offsets);
+	free(state.frontier);
+	free(state.settled_buckets);
+	free(state.claim_rounds);
+	free(state.distances);
+
+	return lengths;
+}
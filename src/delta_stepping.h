@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+// DELTA-STEPPING
+//------------------------------------------------------------------------------
+
+#ifndef _DELTA_STEPPING_H
+#define _DELTA_STEPPING_H
+
+#include <stdbool.h>
+#include "graph.h"
+
+// State shared by all the threads of a delta-stepping run
+// (defined in delta_stepping.c, since it depends on POSIX threads' types)
+typedef struct DeltaSteppingState DeltaSteppingState;
+
+//------------------------------------------------------------------------------
+
+int computeDefaultDelta (Graph* g);
+
+void relaxEdgesInParallel (DeltaSteppingState* state, int thread_num,
+						   int vertex, bool light_edges);
+void buildFrontierInParallel (DeltaSteppingState* state, int thread_num);
+void runDeltaSteppingThread (int thread_num, int nb_threads, void* state);
+
+int* deltaStepping (Graph* g, int s, int delta, int nb_threads);
+
+#endif
@@ -0,0 +1,228 @@
+//------------------------------------------------------------------------------
+// DENSE DIJKSTRA
+//------------------------------------------------------------------------------
+// Vectorized version of the O(#S²) Dijkstra's algorithm, which is the right
+// one for dense graphs (#A close to #S²).
+//
+// All the vertexes have an unsigned key, equal to their tentative length if
+// they have been reached but not settled yet, or to DENSE_NO_KEY otherwise:
+// the visited mask is thus fused in the keys, and the extraction of the minimum
+// is a plain min-index reduction (without any branch), done with SSE4.1/AVX2
+// instructions when the CPU supports them (detected at runtime).
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include "toolbox.h"
+#include "graph.h"
+#include "dijkstra.h"
+#include "dense_dijkstra.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define DENSE_DIJKSTRA_USE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+//------------------------------------------------------------------------------
+// MINIMUM KEY EXTRACTION
+//------------------------------------------------------------------------------
+
+int findMinimumKeyScalar (const unsigned int* keys, int nb_keys)
+{
+	unsigned int min_key = DENSE_NO_KEY;
+	int min_index = -1;
+
+	for (int i = 0; i < nb_keys; i++)
+		if (keys[i] < min_key)
+		{
+			min_key   = keys[i];
+			min_index = i;
+		}
+
+	return min_index;
+}
+
+#ifdef DENSE_DIJKSTRA_USE_X86_SIMD
+
+// Each lane keeps its own minimum and the index where it was found;
+// the lanes (and the remaining keys) are finally reduced with scalar code
+__attribute__((target("sse4.1")))
+int findMinimumKeySSE41 (const unsigned int* keys, int nb_keys)
+{
+	__m128i min_keys 	= _mm_set1_epi32(-1);
+	__m128i min_indexes = _mm_set1_epi32(-1);
+	__m128i indexes 	= _mm_setr_epi32(0, 1, 2, 3);
+	__m128i step 		= _mm_set1_epi32(4);
+
+	int i = 0;
+	for (; i + 4 <= nb_keys; i += 4)
+	{
+		__m128i current_keys = _mm_loadu_si128((const __m128i*) (keys + i));
+		__m128i new_min_keys = _mm_min_epu32(min_keys, current_keys);
+		__m128i unchanged 	 = _mm_cmpeq_epi32(new_min_keys, min_keys);
+
+		min_indexes = _mm_blendv_epi8(indexes, min_indexes, unchanged);
+		min_keys 	= new_min_keys;
+		indexes 	= _mm_add_epi32(indexes, step);
+	}
+
+	unsigned int lane_keys[4];
+	int lane_indexes[4];
+	_mm_storeu_si128((__m128i*) lane_keys, min_keys);
+	_mm_storeu_si128((__m128i*) lane_indexes, min_indexes);
+
+	unsigned int min_key = DENSE_NO_KEY;
+	int min_index = -1;
+
+	for (int lane = 0; lane < 4; lane++)
+		if (lane_keys[lane] < min_key)
+		{
+			min_key   = lane_keys[lane];
+			min_index = lane_indexes[lane];
+		}
+
+	for (; i < nb_keys; i++)
+		if (keys[i] < min_key)
+		{
+			min_key   = keys[i];
+			min_index = i;
+		}
+
+	return min_index;
+}
+
+__attribute__((target("avx2")))
+int findMinimumKeyAVX2 (const unsigned int* keys, int nb_keys)
+{
+	__m256i min_keys 	= _mm256_set1_epi32(-1);
+	__m256i min_indexes = _mm256_set1_epi32(-1);
+	__m256i indexes 	= _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i step 		= _mm256_set1_epi32(8);
+
+	int i = 0;
+	for (; i + 8 <= nb_keys; i += 8)
+	{
+		__m256i current_keys = _mm256_loadu_si256((const __m256i*) (keys + i));
+		__m256i new_min_keys = _mm256_min_epu32(min_keys, current_keys);
+		__m256i unchanged 	 = _mm256_cmpeq_epi32(new_min_keys, min_keys);
+
+		min_indexes = _mm256_blendv_epi8(indexes, min_indexes, unchanged);
+		min_keys 	= new_min_keys;
+		indexes 	= _mm256_add_epi32(indexes, step);
+	}
+
+	unsigned int lane_keys[8];
+	int lane_indexes[8];
+	_mm256_storeu_si256((__m256i*) lane_keys, min_keys);
+	_mm256_storeu_si256((__m256i*) lane_indexes, min_indexes);
+
+	unsigned int min_key = DENSE_NO_KEY;
+	int min_index = -1;
+
+	for (int lane = 0; lane < 8; lane++)
+		if (lane_keys[lane] < min_key)
+		{
+			min_key   = lane_keys[lane];
+			min_index = lane_indexes[lane];
+		}
+
+	for (; i < nb_keys; i++)
+		if (keys[i] < min_key)
+		{
+			min_key   = keys[i];
+			min_index = i;
+		}
+
+	return min_index;
+}
+
+#else
+
+// Without x86 SIMD support, the vectorized versions fall back to scalar code
+int findMinimumKeySSE41 (const unsigned int* keys, int nb_keys)
+{
+	return findMinimumKeyScalar(keys, nb_keys);
+}
+
+int findMinimumKeyAVX2 (const unsigned int* keys, int nb_keys)
+{
+	return findMinimumKeyScalar(keys, nb_keys);
+}
+
+#endif
+
+// Runtime dispatch, according to the instruction sets supported by the CPU
+MinimumKeyFunction selectMinimumKeyFunction ()
+{
+	switch (getSupportedSimdLevel())
+	{
+		case SIMD_AVX2:
+			return findMinimumKeyAVX2;
+		case SIMD_SSE41:
+			return findMinimumKeySSE41;
+		default:
+			return findMinimumKeyScalar;
+	}
+}
+
+//------------------------------------------------------------------------------
+// DENSE DIJKSTRA
+//------------------------------------------------------------------------------
+
+// The returned lengths follow the conventions of dijkstraNaive()
+int* dijkstraDense (Graph* g, int s) // O(#S² + #A)
+{
+	int nb_vertexes = g->nb_vertexes;
+	MinimumKeyFunction findMinimumKey = selectMinimumKeyFunction();
+
+	// Initialization
+	unsigned int* keys 	  = malloc(nb_vertexes * sizeof(unsigned int));
+	unsigned int* lengths = malloc(nb_vertexes * sizeof(unsigned int));
+	CHECK_MALLOC(keys);
+	CHECK_MALLOC(lengths);
+
+	for (int i = 0; i < nb_vertexes; i++)
+	{
+		keys[i]    = DENSE_NO_KEY;
+		lengths[i] = DENSE_NO_KEY;
+	}
+
+	keys[s]    = 0;
+	lengths[s] = 0;
+
+	// Main loop (until no reached vertex remains unsettled)
+	for (int i = 0; i < nb_vertexes; i++)
+	{
+		int min_vertex = findMinimumKey(keys, nb_vertexes);
+		if (min_vertex == -1)
+			break;
+
+		// Settling a vertex only consists in removing its key
+		keys[min_vertex] = DENSE_NO_KEY;
+		unsigned int min_length = lengths[min_vertex];
+
+		// A settled vertex is never updated again, since all weights are
+		// positive or null: no visited test is required here either
+		for (Edge* edge = g->edges[min_vertex]; edge != NULL; edge = edge->next)
+		{
+			unsigned int new_length = min_length + edge->weight;
+
+			if (new_length < lengths[edge->destination])
+			{
+				lengths[edge->destination] = new_length;
+				keys[edge->destination]    = new_length;
+			}
+		}
+	}
+
+	// Conversion to (signed) lengths, reusing the lengths array
+	int* result = (int*) lengths;
+	for (int i = 0; i < nb_vertexes; i++)
+		result[i] = lengths[i] == DENSE_NO_KEY ? INF_LENGTH : (int) lengths[i];
+
+	free(keys);
+	return result;
+}
@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+// DENSE DIJKSTRA
+//------------------------------------------------------------------------------
+
+#ifndef _DENSE_DIJKSTRA_H
+#define _DENSE_DIJKSTRA_H
+
+#include <limits.h>
+#include "graph.h"
+
+// Key of the settled and unreached vertexes (larger than any length)
+#define DENSE_NO_KEY UINT_MAX
+
+// Function returning the index of the smallest key (-1 if all are DENSE_NO_KEY)
+typedef int (*MinimumKeyFunction) (const unsigned int* keys, int nb_keys);
+
+//------------------------------------------------------------------------------
+
+int findMinimumKeyScalar (const unsigned int* keys, int nb_keys);
+int findMinimumKeySSE41 (const unsigned int* keys, int nb_keys);
+int findMinimumKeyAVX2 (const unsigned int* keys, int nb_keys);
+MinimumKeyFunction selectMinimumKeyFunction ();
+
+int* dijkstraDense (Graph* g, int s);
+
+#endif
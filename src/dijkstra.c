@@ -4,48 +4,191 @@
 // Implementation of Dijkstra's algorithm, in two versions:
 // - a naive one with a basic priority structure
 // - an optimized one with a Fibonacci heap
+// Both can work in a reusable workspace, so that back-to-back queries do not
+// require any allocation (nor any O(#S) reinitialization).
+// The predecessor of each vertex is recorded during the relaxations, so that
+// the shortest path tree comes with the lengths (and can be saved as a file).
 //------------------------------------------------------------------------------
 
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
+#include <stdint.h>
 #include "list.h"
 #include "toolbox.h"
 #include "complexity.h"
 #include "graph.h"
 #include "dijkstra.h"
 
+//------------------------------------------------------------------------------
+// WORKSPACE
+//------------------------------------------------------------------------------
+
+// All the memory required by a query is allocated once, here
+DijkstraWorkspace* createDijkstraWorkspace (int nb_vertexes)
+{
+	DijkstraWorkspace* workspace = malloc(sizeof(DijkstraWorkspace));
+	CHECK_MALLOC(workspace);
+
+	workspace->nb_vertexes = nb_vertexes;
+
+	// Stamps are all null, and the first generation is 1: nothing is reached
+	workspace->generation = 1;
+
+	workspace->lengths 				= malloc(nb_vertexes * sizeof(int));
+	workspace->predecessors 		= malloc(nb_vertexes * sizeof(int));
+	workspace->reached_generations 	= calloc(nb_vertexes, sizeof(unsigned int));
+	workspace->settled_generations 	= calloc(nb_vertexes, sizeof(unsigned int));
+	workspace->touched_vertexes 	= malloc(nb_vertexes * sizeof(int));
+	workspace->settled_vertexes 	= malloc(nb_vertexes * sizeof(int));
+	workspace->nodes 				= malloc(nb_vertexes * sizeof(Node));
+	CHECK_MALLOC(workspace->lengths);
+	CHECK_MALLOC(workspace->predecessors);
+	CHECK_MALLOC(workspace->reached_generations);
+	CHECK_MALLOC(workspace->settled_generations);
+	CHECK_MALLOC(workspace->touched_vertexes);
+	CHECK_MALLOC(workspace->settled_vertexes);
+	CHECK_MALLOC(workspace->nodes);
+
+	workspace->nb_touched_vertexes = 0;
+	workspace->nb_settled_vertexes = 0;
+	initFiboHeap(&workspace->fibo_heap);
+
+	return workspace;
+}
+
+void freeDijkstraWorkspace (DijkstraWorkspace* workspace)
+{
+	free(workspace->lengths);
+	free(workspace->predecessors);
+	free(workspace->reached_generations);
+	free(workspace->settled_generations);
+	free(workspace->touched_vertexes);
+	free(workspace->settled_vertexes);
+	free(workspace->nodes);
+
+	free(workspace);
+}
+
+// Start a new generation: O(1), except when the generation counter overflows
+void resetDijkstraWorkspace (DijkstraWorkspace* workspace)
+{
+	(workspace->generation)++;
+
+	if (workspace->generation == 0)
+	{
+		for (int i = 0; i < workspace->nb_vertexes; i++)
+		{
+			workspace->reached_generations[i] = 0;
+			workspace->settled_generations[i] = 0;
+		}
+
+		workspace->generation = 1;
+	}
+
+	workspace->nb_touched_vertexes = 0;
+	workspace->nb_settled_vertexes = 0;
+	initFiboHeap(&workspace->fibo_heap);
+}
+
+bool vertexIsReached (DijkstraWorkspace* workspace, int vertex)
+{
+	return workspace->reached_generations[vertex] == workspace->generation;
+}
+
+// Mark a vertex as settled (its length is final) in the current generation
+void settleVertex (DijkstraWorkspace* workspace, int vertex)
+{
+	workspace->settled_generations[vertex] = workspace->generation;
+
+	workspace->settled_vertexes[workspace->nb_settled_vertexes] = vertex;
+	(workspace->nb_settled_vertexes)++;
+}
+
+bool vertexIsSettled (DijkstraWorkspace* workspace, int vertex)
+{
+	return workspace->settled_generations[vertex] == workspace->generation;
+}
+
+int getLengthFromWorkspace (DijkstraWorkspace* workspace, int vertex)
+{
+	return vertexIsReached(workspace, vertex)
+		 ? workspace->lengths[vertex]
+		 : INF_LENGTH;
+}
+
+int getPredecessorFromWorkspace (DijkstraWorkspace* workspace, int vertex)
+{
+	return vertexIsReached(workspace, vertex)
+		 ? workspace->predecessors[vertex]
+		 : NO_PREDECESSOR;
+}
+
+// Mark a vertex as reached for the first time in the current generation
+void reachVertex (DijkstraWorkspace* workspace, int vertex, int length, int predecessor)
+{
+	workspace->reached_generations[vertex] = workspace->generation;
+	workspace->lengths[vertex] 			   = length;
+	workspace->predecessors[vertex] 	   = predecessor;
+
+	workspace->touched_vertexes[workspace->nb_touched_vertexes] = vertex;
+	(workspace->nb_touched_vertexes)++;
+}
+
+// Returns a new array containing the lengths computed by the last query
+int* copyLengthsFromWorkspace (DijkstraWorkspace* workspace)
+{
+	int* lengths = malloc(workspace->nb_vertexes * sizeof(int));
+	CHECK_MALLOC(lengths);
+
+	for (int i = 0; i < workspace->nb_vertexes; i++)
+		lengths[i] = getLengthFromWorkspace(workspace, i);
+
+	return lengths;
+}
+
+// Fill the given array with the predecessors computed by the last query
+void copyPredecessorsFromWorkspace (DijkstraWorkspace* workspace, int* predecessors)
+{
+	for (int i = 0; i < workspace->nb_vertexes; i++)
+		predecessors[i] = getPredecessorFromWorkspace(workspace, i);
+}
+
 //------------------------------------------------------------------------------
 // NAIVE DIJKSTRA (WITH AN ARRAY)
 //------------------------------------------------------------------------------
 
-int extractMinimumNaive (bool* seen, int* lengths, int nb_vertexes)
+// Only the reached vertexes are candidates, i.e. the touched ones
+// Returns -1 if all of them have already been settled
+int extractMinimumNaive (DijkstraWorkspace* workspace)
 {
 	int i;
 	int min = -1;
+	int* lengths = workspace->lengths;
 	COMPLEXITY += 2;
 
 	// Find the minimum
-	for (i = 0; i < nb_vertexes; i++)
-	{	
-		
+	for (i = 0; i < workspace->nb_touched_vertexes; i++)
+	{
+		int vertex = workspace->touched_vertexes[i];
+
 		COMPLEXITY +=2;
-		if (lengths[i] != INF_LENGTH
-		&& !seen[i])
+		if (! vertexIsSettled(workspace, vertex))
 		{
 			COMPLEXITY++;
 			if (min == -1)
 			{
-			min = i;
-			COMPLEXITY++;
-			} 
-			else 
+				min = vertex;
+				COMPLEXITY++;
+			}
+			else
 			{
 				COMPLEXITY++;
-				if (lengths[min] > lengths[i])
+				if (lengths[min] > lengths[vertex])
 				{
-					min = i;
+					min = vertex;
 					COMPLEXITY++;
 				}
 			}
@@ -55,22 +198,14 @@ int extractMinimumNaive (bool* seen, int* lengths, int nb_vertexes)
 	return min;
 }
 
-int* dijkstraNaive (Graph* g, int s) // O(#A²)
+void dijkstraNaiveInWorkspace (Graph* g, int s, DijkstraWorkspace* workspace) // O(#A²)
 {
-	// Initialization
-	int* lengths = malloc(g->nb_vertexes * sizeof(int));
-	CHECK_MALLOC(lengths);
-	bool seen[g->nb_vertexes];
-	COMPLEXITY = g->nb_vertexes +1;
-
-	for (int i = 0 ; i < g->nb_vertexes; i++)
-	{
-		seen[i]    = false;
-		lengths[i] = INF_LENGTH;
-		COMPLEXITY += 3;
-	}
+	// Initialization (no need to clear the arrays, thanks to the generations)
+	resetDijkstraWorkspace(workspace);
+	int* lengths = workspace->lengths;
+	COMPLEXITY = 2;
 
-	lengths[s] = 0;
+	reachVertex(workspace, s, 0, NO_PREDECESSOR);
 	COMPLEXITY++;
 
 
@@ -78,10 +213,14 @@ int* dijkstraNaive (Graph* g, int s) // O(#A²)
 	for (int i = 0; i < g->nb_vertexes; i++)
 	{
 		COMPLEXITY ++;
-		
+
 		// The element with the smallest distance is extracted
-		int min_elt = extractMinimumNaive(seen, lengths, g->nb_vertexes);
-		seen[min_elt] = true;
+		// (if there is none, the remaining vertexes are unreachable)
+		int min_elt = extractMinimumNaive(workspace);
+		if (min_elt == -1)
+			break;
+
+		settleVertex(workspace, min_elt);
 		COMPLEXITY++;
 
 		// Iteration over all min_elt's neighbours
@@ -98,16 +237,34 @@ int* dijkstraNaive (Graph* g, int s) // O(#A²)
 
 
 			COMPLEXITY +=2;
-			if (lengths[neighbour] == INF_LENGTH
-			||  lengths[neighbour] > lengths[min_elt] + weight)
+			if (! vertexIsReached(workspace, neighbour))
 			{
-				lengths[neighbour] = lengths[min_elt] + weight;
+				reachVertex(workspace, neighbour, lengths[min_elt] + weight, min_elt);
 				COMPLEXITY++;
 			}
+			else if (lengths[neighbour] > lengths[min_elt] + weight)
+			{
+				lengths[neighbour] = lengths[min_elt] + weight;
+				workspace->predecessors[neighbour] = min_elt;
+				COMPLEXITY += 2;
+			}
 			current_edge = current_edge->next;
 			COMPLEXITY++;
 		}
 	}
+}
+
+// The predecessors are also copied, unless the given array is NULL
+int* dijkstraNaive (Graph* g, int s, int* predecessors)
+{
+	DijkstraWorkspace* workspace = createDijkstraWorkspace(g->nb_vertexes);
+
+	dijkstraNaiveInWorkspace(g, s, workspace);
+	int* lengths = copyLengthsFromWorkspace(workspace);
+	if (predecessors != NULL)
+		copyPredecessorsFromWorkspace(workspace, predecessors);
+
+	freeDijkstraWorkspace(workspace);
 	return lengths;
 }
 
@@ -115,59 +272,304 @@ int* dijkstraNaive (Graph* g, int s) // O(#A²)
 // OPTIMIZED DIJKSTRA (WITH A FIBONACCI HEAP)
 //------------------------------------------------------------------------------
 
-int* dijkstra (Graph* g, int s)
+// Start a new query from s: only s is reached
+// The vertexes are only inserted in the heap once they are reached,
+// using the node handles of the workspace (no allocation at all)
+void startDijkstraInWorkspace (int s, DijkstraWorkspace* workspace)
 {
-	// Initialization
-	int* lengths = malloc(g->nb_vertexes * sizeof(int));
-	CHECK_MALLOC(lengths);
+	resetDijkstraWorkspace(workspace);
+
+	reachVertex(workspace, s, 0, NO_PREDECESSOR);
+	initIsolatedNode(&workspace->nodes[s], s, 0);
+	insertRootInFiboHeap(&workspace->fibo_heap, &workspace->nodes[s]);
+}
+
+// Settle the closest unsettled vertex, and relax its edges
+// Returns the settled vertex, or -1 if there is no reached unsettled vertex
+int settleNextVertex (Graph* g, DijkstraWorkspace* workspace)
+{
+	int* lengths 		= workspace->lengths;
+	FiboHeap* fibo_heap = &workspace->fibo_heap;
+	Node* vertexes 		= workspace->nodes;
+
+	if (fibo_heap->min_element == NULL)
+		return -1;
+
+	// The element with the smallest distance is extracted
+	Node* extracted_min = extractMinFromFiboHeap(fibo_heap);
 
-	FiboHeap* fibo_heap = createFiboHeap();
+	int min_vertex = extracted_min->value;
+	settleVertex(workspace, min_vertex);
 
-	Node* vertexes[g->nb_vertexes];
-	int key;
-	for (int i = 0 ; i < g->nb_vertexes; i++)
+	// Iteration over all min_vertex's neighbours
+	Edge* current_edge = g->edges[min_vertex];
+	while (current_edge != NULL)
 	{
-		// Every vertex but the origin s is assigned a very big key
-		key = i == s ? 0 : MAX_LENGTH;
+		int neighbour = current_edge->destination;
 
-		vertexes[i] = createIsolatedNode(i, key);
-		insertRootInFiboHeap(fibo_heap, vertexes[i]);
+		// Improve the lengths if possible (and update the heap if required)
+		int weight = current_edge->weight;
+		int new_length = lengths[min_vertex] + weight;
+
+		if (! vertexIsReached(workspace, neighbour))
+		{
+			reachVertex(workspace, neighbour, new_length, min_vertex);
+			initIsolatedNode(&vertexes[neighbour], neighbour, new_length);
+			insertRootInFiboHeap(fibo_heap, &vertexes[neighbour]);
+		}
+		else if (! vertexIsSettled(workspace, neighbour)
+			 &&  lengths[neighbour] > new_length)
+		{
+			lengths[neighbour] = new_length;
+			workspace->predecessors[neighbour] = min_vertex;
+			decreaseKeyInFiboHeap(fibo_heap, &vertexes[neighbour], new_length);
+		}
+
+		current_edge = current_edge->next;
 	}
 
-	// Main loop (over the Fibonacci heap's content, i.e. unseen vertexes)
-	for (int i = 0; i < g->nb_vertexes; i++)
+	return min_vertex;
+}
+
+// The search stops as soon as the next vertex to settle is farther than
+// max_length, or max_nb_vertexes vertexes have been settled (NO_BOUND for none)
+void dijkstraBoundedInWorkspace (Graph* g, int s, int max_length, int max_nb_vertexes,
+								 DijkstraWorkspace* workspace)
+{
+	FiboHeap* fibo_heap = &workspace->fibo_heap;
+	startDijkstraInWorkspace(s, workspace);
+
+	// Main loop (over the Fibonacci heap's content, i.e. reached unseen vertexes)
+	while (fibo_heap->min_element != NULL)
 	{
-		// The element with the smallest distance is extracted
-		Node* extracted_min = extractMinFromFiboHeap(fibo_heap);
+		// Stop if one of the bounds has been reached
+		if (fibo_heap->min_element->key > max_length)
+			break;
+		if (workspace->nb_settled_vertexes >= max_nb_vertexes)
+			break;
 
-/*	
-		printFiboHeap(fibo_heap);
-		printf("Extracted min number %d:\n", i);
-		assert(extracted_min != NULL);
-*/
-		int min_vertex = extracted_min->value;
+		settleNextVertex(g, workspace);
+	}
+}
 
-		// Iteration over all min_vertex's neighbours
-		Edge* current_edge = g->edges[min_vertex];
-		while (current_edge != NULL)
+void dijkstraInWorkspace (Graph* g, int s, DijkstraWorkspace* workspace)
+{
+	dijkstraBoundedInWorkspace(g, s, NO_BOUND, NO_BOUND, workspace);
+}
+
+// The predecessors are also copied, unless the given array is NULL
+int* dijkstra (Graph* g, int s, int* predecessors)
+{
+	DijkstraWorkspace* workspace = createDijkstraWorkspace(g->nb_vertexes);
+
+	dijkstraInWorkspace(g, s, workspace);
+	int* lengths = copyLengthsFromWorkspace(workspace);
+	if (predecessors != NULL)
+		copyPredecessorsFromWorkspace(workspace, predecessors);
+
+	freeDijkstraWorkspace(workspace);
+	return lengths;
+}
+
+//------------------------------------------------------------------------------
+// BOUNDED QUERIES (RADIUS, NEAREST VERTEXES)
+//------------------------------------------------------------------------------
+
+// Returns the settled vertexes of the last query (by increasing length)
+// Only O(#settled) memory is allocated, whatever the size of the graph
+SparseLengths* copySettledLengthsFromWorkspace (DijkstraWorkspace* workspace)
+{
+	int nb_vertexes = workspace->nb_settled_vertexes;
+
+	SparseLengths* sparse_lengths = malloc(sizeof(SparseLengths));
+	CHECK_MALLOC(sparse_lengths);
+
+	sparse_lengths->nb_vertexes = nb_vertexes;
+	sparse_lengths->vertexes 	= malloc(nb_vertexes * sizeof(int));
+	sparse_lengths->lengths 	= malloc(nb_vertexes * sizeof(int));
+	CHECK_MALLOC(sparse_lengths->vertexes);
+	CHECK_MALLOC(sparse_lengths->lengths);
+
+	for (int i = 0; i < nb_vertexes; i++)
+	{
+		int vertex = workspace->settled_vertexes[i];
+
+		sparse_lengths->vertexes[i] = vertex;
+		sparse_lengths->lengths[i]  = workspace->lengths[vertex];
+	}
+
+	return sparse_lengths;
+}
+
+void freeSparseLengths (SparseLengths* sparse_lengths)
+{
+	free(sparse_lengths->vertexes);
+	free(sparse_lengths->lengths);
+
+	free(sparse_lengths);
+}
+
+// All the vertexes at distance <= radius from s
+SparseLengths* findVertexesWithinRadius (Graph* g, int s, int radius,
+										 DijkstraWorkspace* workspace)
+{
+	if (radius < 0)
+	{
+		fprintf(stderr, "Error: negative radius %d.\n", radius);
+		exit(1);
+	}
+
+	dijkstraBoundedInWorkspace(g, s, radius, NO_BOUND, workspace);
+	return copySettledLengthsFromWorkspace(workspace);
+}
+
+// The nb_vertexes closest vertexes to s (s included)
+SparseLengths* findNearestVertexes (Graph* g, int s, int nb_vertexes,
+									DijkstraWorkspace* workspace)
+{
+	if (nb_vertexes < 0)
+	{
+		fprintf(stderr, "Error: negative number of vertexes %d.\n", nb_vertexes);
+		exit(1);
+	}
+
+	dijkstraBoundedInWorkspace(g, s, NO_BOUND, nb_vertexes, workspace);
+	return copySettledLengthsFromWorkspace(workspace);
+}
+
+//------------------------------------------------------------------------------
+// SHORTEST PATH TREES
+//------------------------------------------------------------------------------
+
+ShortestPathTree* computeShortestPathTree (Graph* g, int s)
+{
+	ShortestPathTree* tree = malloc(sizeof(ShortestPathTree));
+	CHECK_MALLOC(tree);
+
+	tree->nb_vertexes  = g->nb_vertexes;
+	tree->source 	   = s;
+	tree->predecessors = malloc(g->nb_vertexes * sizeof(int));
+	CHECK_MALLOC(tree->predecessors);
+	tree->lengths 	   = dijkstra(g, s, tree->predecessors);
+
+	return tree;
+}
+
+void freeShortestPathTree (ShortestPathTree* tree)
+{
+	free(tree->lengths);
+	free(tree->predecessors);
+
+	free(tree);
+}
+
+// Returns a new array with the vertexes of the path from the source to the
+// destination (both included), in O(path length), or NULL if it is unreachable
+int* extractShortestPath (ShortestPathTree* tree, int destination, int* nb_path_vertexes)
+{
+	if (tree->lengths[destination] == INF_LENGTH)
+	{
+		*nb_path_vertexes = 0;
+		return NULL;
+	}
+
+	// A path has at most nb_vertexes vertexes: a longer chain of predecessors
+	// means that they contain a cycle (the tree has been read from a bad file)
+	int nb_vertexes = 1;
+	for (int v = destination; v != tree->source; v = tree->predecessors[v])
+	{
+		nb_vertexes++;
+
+		if (nb_vertexes > tree->nb_vertexes || tree->predecessors[v] == NO_PREDECESSOR)
 		{
-			int neighbour = current_edge->destination;
+			fprintf(stderr, "Error: shortest path tree has a bad predecessor chain.\n");
+			exit(1);
+		}
+	}
 
-			// Improve the lengths if possible (and update the heap if required)
-			int weight = current_edge->weight;
-			int new_length = lengths[min_vertex] + weight;
+	int* path = malloc(nb_vertexes * sizeof(int));
+	CHECK_MALLOC(path);
 
-			if (lengths[neighbour] == MAX_LENGTH
-			||  lengths[neighbour] > new_length)
-			{
-				lengths[neighbour] = new_length;
-				decreaseKeyInFiboHeap(fibo_heap, vertexes[neighbour], new_length);
-			}
+	int v = destination;
+	for (int i = nb_vertexes - 1; i >= 0; i--)
+	{
+		path[i] = v;
+		v = tree->predecessors[v];
+	}
 
-			current_edge = current_edge->next;
+	*nb_path_vertexes = nb_vertexes;
+	return path;
+}
+
+// Binary format described in dijkstra.h
+void writeShortestPathTree (FILE* file, ShortestPathTree* tree)
+{
+	ShortestPathTreeFileHeader header;
+	memcpy(header.magic, SHORTEST_PATH_TREE_FILE_MAGIC, 4);
+	header.nb_vertexes = tree->nb_vertexes;
+	header.source 	   = tree->source;
+	header.reserved    = 0;
+
+	size_t nb_vertexes = tree->nb_vertexes;
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1
+	||  fwrite(tree->predecessors, sizeof(int32_t), nb_vertexes, file) != nb_vertexes
+	||  fwrite(tree->lengths, sizeof(int32_t), nb_vertexes, file) != nb_vertexes)
+	{
+		fprintf(stderr, "Error: shortest path tree writing failed.\n");
+		exit(1);
+	}
+}
+
+ShortestPathTree* readShortestPathTree (FILE* file)
+{
+	ShortestPathTreeFileHeader header;
+
+	if (fread(&header, sizeof(header), 1, file) != 1
+	||  memcmp(header.magic, SHORTEST_PATH_TREE_FILE_MAGIC, 4) != 0
+	||  header.nb_vertexes < 1
+	||  header.source < 0 || header.source >= header.nb_vertexes)
+	{
+		fprintf(stderr, "Error: shortest path tree file has a bad header.\n");
+		exit(1);
+	}
+
+	ShortestPathTree* tree = malloc(sizeof(ShortestPathTree));
+	CHECK_MALLOC(tree);
+
+	tree->nb_vertexes  = header.nb_vertexes;
+	tree->source 	   = header.source;
+	tree->predecessors = malloc(header.nb_vertexes * sizeof(int));
+	tree->lengths 	   = malloc(header.nb_vertexes * sizeof(int));
+	CHECK_MALLOC(tree->predecessors);
+	CHECK_MALLOC(tree->lengths);
+
+	size_t nb_vertexes = tree->nb_vertexes;
+
+	if (fread(tree->predecessors, sizeof(int32_t), nb_vertexes, file) != nb_vertexes
+	||  fread(tree->lengths, sizeof(int32_t), nb_vertexes, file) != nb_vertexes)
+	{
+		fprintf(stderr, "Error: shortest path tree file is truncated.\n");
+		exit(1);
+	}
+
+	// Every predecessor must be a vertex (or NO_PREDECESSOR for the source and
+	// the unreachable vertexes), and a reachable vertex must have a reachable one
+	for (int i = 0; i < tree->nb_vertexes; i++)
+	{
+		int predecessor = tree->predecessors[i];
+		bool is_reached = tree->lengths[i] != INF_LENGTH;
+
+		if (predecessor < NO_PREDECESSOR || predecessor >= tree->nb_vertexes
+		||  tree->lengths[i] < INF_LENGTH
+		||  (i == tree->source && (predecessor != NO_PREDECESSOR || tree->lengths[i] != 0))
+		||  (i != tree->source && is_reached != (predecessor != NO_PREDECESSOR))
+		||  (predecessor != NO_PREDECESSOR && tree->lengths[predecessor] == INF_LENGTH))
+		{
+			fprintf(stderr, "Error: shortest path tree file is corrupted.\n");
+			exit(1);
 		}
 	}
 
-	freeFiboHeap(fibo_heap);
-	return lengths;
+	return tree;
 }
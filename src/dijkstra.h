@@ -5,17 +5,117 @@
 #ifndef _DIJKSTRA_H
 #define _DIJKSTRA_H
 
+#include <stdio.h>
+#include <stdint.h>
 #include "graph.h"
+#include "fibonacci_heap.h"
 #include <limits.h>
 
 // Unreachable length (all lengths are positive or null)
 #define INF_LENGTH -1
 #define MAX_LENGTH INT_MAX // the larger value a 32 bits signed integer can hold
 
+// Predecessor of the source and of the unreachable vertexes
+#define NO_PREDECESSOR -1
+
+// Absence of bound for the bounded queries (on the length or number of vertexes)
+// It is larger than any length or number of vertexes, so that it never stops
+// a search, and cannot be confused with a (negative) invalid bound
+#define NO_BOUND INT_MAX
+
+// Persistent memory of Dijkstra's algorithms, reusable from one query to another
+// The entries of a vertex are only meaningful if its generation stamp is equal
+// to the current generation: a reset thus does not require to clear all of them
+typedef struct DijkstraWorkspace
+{
+	int nb_vertexes;
+	unsigned int generation;
+
+	// Lengths and predecessors on the shortest paths
+	// (valid if the vertex has been reached in the current generation)
+	int* lengths;
+	int* predecessors;
+	unsigned int* reached_generations;
+	unsigned int* settled_generations;
+
+	// Vertexes reached during the current generation (in order of discovery)
+	int* touched_vertexes;
+	int nb_touched_vertexes;
+
+	// Vertexes settled during the current generation (in order of length)
+	int* settled_vertexes;
+	int nb_settled_vertexes;
+
+	// Fibonacci heap and its nodes (one handle per vertex)
+	FiboHeap fibo_heap;
+	Node* nodes;
+} DijkstraWorkspace;
+
+// Result of a bounded query: only the settled vertexes and their lengths
+typedef struct SparseLengths
+{
+	int nb_vertexes;
+	int* vertexes;
+	int* lengths;
+} SparseLengths;
+
+// Shortest paths from a source: lengths and predecessors (NO_PREDECESSOR for
+// the source and the unreachable vertexes)
+typedef struct ShortestPathTree
+{
+	int nb_vertexes;
+	int source;
+	int* lengths;
+	int* predecessors;
+} ShortestPathTree;
+
+// Header of a shortest path tree file, followed by the predecessors (int32)
+// and the lengths (int32) of all the vertexes
+#define SHORTEST_PATH_TREE_FILE_MAGIC "SPTR"
+typedef struct ShortestPathTreeFileHeader
+{
+	char magic[4];
+	int32_t nb_vertexes;
+	int32_t source;
+	int32_t reserved;
+} ShortestPathTreeFileHeader;
+
 //------------------------------------------------------------------------------
 
-int extractMinimumNaive(bool*, int*, int);
-int* dijkstraNaive(Graph* g, int s);
-int* dijkstra (Graph* g, int s);
+DijkstraWorkspace* createDijkstraWorkspace (int nb_vertexes);
+void freeDijkstraWorkspace (DijkstraWorkspace* workspace);
+void resetDijkstraWorkspace (DijkstraWorkspace* workspace);
+bool vertexIsReached (DijkstraWorkspace* workspace, int vertex);
+bool vertexIsSettled (DijkstraWorkspace* workspace, int vertex);
+int getLengthFromWorkspace (DijkstraWorkspace* workspace, int vertex);
+int getPredecessorFromWorkspace (DijkstraWorkspace* workspace, int vertex);
+void reachVertex (DijkstraWorkspace* workspace, int vertex, int length, int predecessor);
+void settleVertex (DijkstraWorkspace* workspace, int vertex);
+int* copyLengthsFromWorkspace (DijkstraWorkspace* workspace);
+void copyPredecessorsFromWorkspace (DijkstraWorkspace* workspace, int* predecessors);
+
+int extractMinimumNaive (DijkstraWorkspace* workspace);
+void dijkstraNaiveInWorkspace (Graph* g, int s, DijkstraWorkspace* workspace);
+int* dijkstraNaive (Graph* g, int s, int* predecessors);
+
+void startDijkstraInWorkspace (int s, DijkstraWorkspace* workspace);
+int settleNextVertex (Graph* g, DijkstraWorkspace* workspace);
+void dijkstraInWorkspace (Graph* g, int s, DijkstraWorkspace* workspace);
+int* dijkstra (Graph* g, int s, int* predecessors);
+
+void dijkstraBoundedInWorkspace (Graph* g, int s, int max_length, int max_nb_vertexes,
+								 DijkstraWorkspace* workspace);
+SparseLengths* copySettledLengthsFromWorkspace (DijkstraWorkspace* workspace);
+void freeSparseLengths (SparseLengths* sparse_lengths);
+SparseLengths* findVertexesWithinRadius (Graph* g, int s, int radius,
+										 DijkstraWorkspace* workspace);
+SparseLengths* findNearestVertexes (Graph* g, int s, int nb_vertexes,
+									DijkstraWorkspace* workspace);
+
+ShortestPathTree* computeShortestPathTree (Graph* g, int s);
+void freeShortestPathTree (ShortestPathTree* tree);
+int* extractShortestPath (ShortestPathTree* tree, int destination, int* nb_path_vertexes);
+void writeShortestPathTree (FILE* file, ShortestPathTree* tree);
+ShortestPathTree* readShortestPathTree (FILE* file);
 
 #endif
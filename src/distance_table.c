@@ -0,0 +1,363 @@
+//------------------------------------------------------------------------------
+// DISTANCE TABLE (MANY-TO-MANY SHORTEST PATHS)
+//------------------------------------------------------------------------------
+// Lengths between every source and every target of two sets of vertexes,
+// with the bucket-based many-to-many algorithm:
+// 1. A backward search from each target t settles at most bucket_budget
+//    vertexes, and leaves (t, length to t) in the bucket of each of them.
+//    All the vertexes closer to t than its radius are then in the buckets.
+// 2. A forward search from each source s scans the buckets of the vertexes it
+//    settles and of their neighbours: a shortest path to t either has all its
+//    vertexes settled by the forward search, or leaves the forward search space
+//    through an edge (u, v), where v is in the bucket of t or farther than its
+//    radius. The search stops once the lengths found cannot be improved anymore.
+//
+// Graphs are undirected: the backward searches are plain Dijkstra's searches.
+// Both phases are run in parallel (one search per task, one workspace per
+// thread), and the buckets are compacted in a single array between them.
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "toolbox.h"
+#include "graph.h"
+#include "dijkstra.h"
+#include "parallel.h"
+#include "distance_table.h"
+
+// Length of an unknown path, and radius of an exhaustive backward search
+// (small enough for their difference not to overflow)
+#define UNREACHED_LENGTH (LONG_MAX / 4)
+#define INFINITE_RADIUS  (LONG_MAX / 4)
+
+// Total number of bucket entries of the default budget (8 bytes each)
+#define DEFAULT_NB_BUCKET_ENTRIES (1 << 24)
+
+// Work shared by the threads of a phase
+struct DistanceTableState
+{
+	Graph* graph;
+	int* sources;
+	int nb_sources;
+	int* targets;
+	int nb_targets;
+	int bucket_budget;
+
+	// Next search to be run by a thread
+	int next_task;
+
+	// Vertexes settled by the backward search of each target
+	SparseLengths** backward_results;
+	VertexBuckets buckets;
+
+	// Output table
+	int* lengths;
+};
+
+//------------------------------------------------------------------------------
+// BACKWARD SEARCHES
+//------------------------------------------------------------------------------
+
+// Buckets of at most DEFAULT_NB_BUCKET_ENTRIES entries in total
+int computeDefaultBucketBudget (int nb_vertexes, int nb_targets)
+{
+	int budget = DEFAULT_NB_BUCKET_ENTRIES / (nb_targets < 1 ? 1 : nb_targets);
+
+	if (budget < 64)
+		budget = 64;
+	if (budget > nb_vertexes)
+		budget = nb_vertexes;
+
+	return budget;
+}
+
+void runBackwardSearches (int thread_num, int nb_threads, void* argument)
+{
+	(void) thread_num;
+	(void) nb_threads;
+
+	DistanceTableState* state = argument;
+	DijkstraWorkspace* workspace = createDijkstraWorkspace(state->graph->nb_vertexes);
+
+	while (true)
+	{
+		int target_num = __atomic_fetch_add(&state->next_task, 1, __ATOMIC_RELAXED);
+		if (target_num >= state->nb_targets)
+			break;
+
+		dijkstraBoundedInWorkspace(state->graph, state->targets[target_num],
+								   NO_BOUND, state->bucket_budget, workspace);
+		state->backward_results[target_num] = copySettledLengthsFromWorkspace(workspace);
+
+		// The unsettled vertexes are at least as far as the next one to settle
+		FiboHeap* fibo_heap = &workspace->fibo_heap;
+		state->buckets.radiuses[target_num] = fibo_heap->min_element == NULL
+											? INFINITE_RADIUS
+											: (long) fibo_heap->min_element->key - 1;
+	}
+
+	freeDijkstraWorkspace(workspace);
+}
+
+// Gather the results of the backward searches in the buckets (counting sort)
+void buildVertexBuckets (DistanceTableState* state)
+{
+	VertexBuckets* buckets = &state->buckets;
+	int nb_vertexes = buckets->nb_vertexes;
+
+	buckets->offsets = calloc(nb_vertexes + 1, sizeof(long));
+	CHECK_MALLOC(buckets->offsets);
+
+	for (int t = 0; t < state->nb_targets; t++)
+	{
+		SparseLengths* result = state->backward_results[t];
+		for (int i = 0; i < result->nb_vertexes; i++)
+			(buckets->offsets[result->vertexes[i] + 1])++;
+	}
+
+	for (int v = 0; v < nb_vertexes; v++)
+		buckets->offsets[v + 1] += buckets->offsets[v];
+
+	buckets->entries = malloc((buckets->offsets[nb_vertexes] + 1) * sizeof(BucketEntry));
+	CHECK_MALLOC(buckets->entries);
+
+	long* positions = malloc(nb_vertexes * sizeof(long));
+	CHECK_MALLOC(positions);
+	memcpy(positions, buckets->offsets, nb_vertexes * sizeof(long));
+
+	for (int t = 0; t < state->nb_targets; t++)
+	{
+		SparseLengths* result = state->backward_results[t];
+		for (int i = 0; i < result->nb_vertexes; i++)
+		{
+			BucketEntry* entry = &buckets->entries[positions[result->vertexes[i]]++];
+			entry->target_num = t;
+			entry->length 	  = result->lengths[i];
+		}
+
+		freeSparseLengths(result);
+		state->backward_results[t] = NULL;
+	}
+
+	free(positions);
+}
+
+void freeVertexBuckets (VertexBuckets* buckets)
+{
+	free(buckets->offsets);
+	free(buckets->entries);
+	free(buckets->radiuses);
+}
+
+//------------------------------------------------------------------------------
+// FORWARD SEARCHES
+//------------------------------------------------------------------------------
+
+// Improve the row of lengths with the paths through the given vertex
+// (length is the length of the path from the source to this vertex)
+// Returns the number of scanned entries
+long scanVertexBucket (VertexBuckets* buckets, int vertex, long length, long* row)
+{
+	long start = buckets->offsets[vertex];
+	long end   = buckets->offsets[vertex + 1];
+
+	for (long i = start; i < end; i++)
+	{
+		BucketEntry* entry = &buckets->entries[i];
+		long new_length = length + entry->length;
+
+		if (new_length < row[entry->target_num])
+			row[entry->target_num] = new_length;
+	}
+
+	return end - start;
+}
+
+// Once the next vertex to settle is at least at this length, the lengths of
+// the row are final: max over the targets of (length found - radius)
+long computeStoppingLength (VertexBuckets* buckets, long* row)
+{
+	long stopping_length = LONG_MIN;
+
+	for (int t = 0; t < buckets->nb_targets; t++)
+	{
+		long target_stopping_length = row[t] - buckets->radiuses[t];
+		if (target_stopping_length > stopping_length)
+			stopping_length = target_stopping_length;
+	}
+
+	return stopping_length;
+}
+
+void runForwardSearch (Graph* g, int source_num, DistanceTableState* state,
+					   DijkstraWorkspace* workspace, long* row)
+{
+	VertexBuckets* buckets = &state->buckets;
+	FiboHeap* fibo_heap = &workspace->fibo_heap;
+
+	for (int t = 0; t < state->nb_targets; t++)
+		row[t] = UNREACHED_LENGTH;
+
+	startDijkstraInWorkspace(state->sources[source_num], workspace);
+
+	// The stopping length can only decrease as the lengths are improved: it
+	// is recomputed once every nb_targets settled vertexes (amortized O(1))
+	long stopping_length = UNREACHED_LENGTH;
+	int nb_vertexes_before_update = 0;
+
+	while (fibo_heap->min_element != NULL
+	   &&  fibo_heap->min_element->key < stopping_length)
+	{
+		int vertex = settleNextVertex(g, workspace);
+		long length = workspace->lengths[vertex];
+
+		scanVertexBucket(buckets, vertex, length, row);
+		for (Edge* edge = g->edges[vertex]; edge != NULL; edge = edge->next)
+			scanVertexBucket(buckets, edge->destination, length + edge->weight, row);
+
+		if (nb_vertexes_before_update == 0)
+		{
+			stopping_length = computeStoppingLength(buckets, row);
+			nb_vertexes_before_update = state->nb_targets;
+		}
+		nb_vertexes_before_update--;
+	}
+
+	// Storage of the row in the table
+	int* lengths = &state->lengths[(long) source_num * state->nb_targets];
+	for (int t = 0; t < state->nb_targets; t++)
+		lengths[t] = row[t] == UNREACHED_LENGTH ? INF_LENGTH : (int) row[t];
+}
+
+void runForwardSearches (int thread_num, int nb_threads, void* argument)
+{
+	(void) thread_num;
+	(void) nb_threads;
+
+	DistanceTableState* state = argument;
+	DijkstraWorkspace* workspace = createDijkstraWorkspace(state->graph->nb_vertexes);
+
+	long* row = malloc(state->nb_targets * sizeof(long));
+	CHECK_MALLOC(row);
+
+	while (true)
+	{
+		int source_num = __atomic_fetch_add(&state->next_task, 1, __ATOMIC_RELAXED);
+		if (source_num >= state->nb_sources)
+			break;
+
+		runForwardSearch(state->graph, source_num, state, workspace, row);
+	}
+
+	free(row);
+	freeDijkstraWorkspace(workspace);
+}
+
+//------------------------------------------------------------------------------
+// DISTANCE TABLE
+//------------------------------------------------------------------------------
+
+// A null or negative bucket budget (resp. number of threads) selects a
+// default value; the sources and targets arrays are copied
+DistanceTable* computeDistanceTable (Graph* g, int* sources, int nb_sources,
+									 int* targets, int nb_targets,
+									 int bucket_budget, int nb_threads)
+{
+	for (int i = 0; i < nb_sources; i++)
+		if (sources[i] < 0 || sources[i] >= g->nb_vertexes)
+		{
+			fprintf(stderr, "Error: invalid source vertex %d.\n", sources[i]);
+			exit(1);
+		}
+	for (int i = 0; i < nb_targets; i++)
+		if (targets[i] < 0 || targets[i] >= g->nb_vertexes)
+		{
+			fprintf(stderr, "Error: invalid target vertex %d.\n", targets[i]);
+			exit(1);
+		}
+
+	if (bucket_budget <= 0)
+		bucket_budget = computeDefaultBucketBudget(g->nb_vertexes, nb_targets);
+	if (nb_threads <= 0)
+		nb_threads = getNbAvailableCores();
+
+	DistanceTable* table = malloc(sizeof(DistanceTable));
+	CHECK_MALLOC(table);
+
+	table->nb_sources = nb_sources;
+	table->nb_targets = nb_targets;
+	table->sources = malloc((nb_sources + 1) * sizeof(int));
+	table->targets = malloc((nb_targets + 1) * sizeof(int));
+	table->lengths = malloc(((long) nb_sources * nb_targets + 1) * sizeof(int));
+	CHECK_MALLOC(table->sources);
+	CHECK_MALLOC(table->targets);
+	CHECK_MALLOC(table->lengths);
+
+	memcpy(table->sources, sources, nb_sources * sizeof(int));
+	memcpy(table->targets, targets, nb_targets * sizeof(int));
+
+	// Initialization of the shared state
+	DistanceTableState state;
+	state.graph 		= g;
+	state.sources 		= table->sources;
+	state.nb_sources 	= nb_sources;
+	state.targets 		= table->targets;
+	state.nb_targets 	= nb_targets;
+	state.bucket_budget = bucket_budget;
+	state.lengths 		= table->lengths;
+
+	state.buckets.nb_vertexes = g->nb_vertexes;
+	state.buckets.nb_targets  = nb_targets;
+	state.buckets.radiuses 	  = malloc((nb_targets + 1) * sizeof(long));
+	state.backward_results 	  = malloc((nb_targets + 1) * sizeof(SparseLengths*));
+	CHECK_MALLOC(state.buckets.radiuses);
+	CHECK_MALLOC(state.backward_results);
+
+	// 1. Backward searches, from the targets
+	state.next_task = 0;
+	runInParallel(nb_threads, runBackwardSearches, &state);
+
+	buildVertexBuckets(&state);
+	free(state.backward_results);
+
+	// 2. Forward searches, from the sources
+	state.next_task = 0;
+	runInParallel(nb_threads, runForwardSearches, &state);
+
+	freeVertexBuckets(&state.buckets);
+
+	return table;
+}
+
+void freeDistanceTable (DistanceTable* table)
+{
+	free(table->sources);
+	free(table->targets);
+	free(table->lengths);
+	free(table);
+}
+
+// Binary format described in distance_table.h
+void writeDistanceTable (FILE* file, DistanceTable* table)
+{
+	DistanceTableFileHeader header;
+	memcpy(header.magic, DISTANCE_TABLE_FILE_MAGIC, 4);
+	header.nb_sources = table->nb_sources;
+	header.nb_targets = table->nb_targets;
+	header.reserved   = 0;
+
+	size_t nb_lengths = (size_t) table->nb_sources * table->nb_targets;
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1
+	||  fwrite(table->sources, sizeof(int32_t), table->nb_sources, file) != (size_t) table->nb_sources
+	||  fwrite(table->targets, sizeof(int32_t), table->nb_targets, file) != (size_t) table->nb_targets
+	||  fwrite(table->lengths, sizeof(int32_t), nb_lengths, file) != nb_lengths)
+	{
+		fprintf(stderr, "Error: distance table writing failed.\n");
+		exit(1);
+	}
+}
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// DISTANCE TABLE (MANY-TO-MANY SHORTEST PATHS)
+//------------------------------------------------------------------------------
+
+#ifndef _DISTANCE_TABLE_H
+#define _DISTANCE_TABLE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "graph.h"
+#include "dijkstra.h"
+
+// Header of a distance table file, followed by the sources (int32), the targets
+// (int32), and the row-major table: nb_sources * nb_targets lengths (int32),
+// INF_LENGTH if unreachable
+#define DISTANCE_TABLE_FILE_MAGIC "DTAB"
+typedef struct DistanceTableFileHeader
+{
+	char magic[4];
+	int32_t nb_sources;
+	int32_t nb_targets;
+	int32_t reserved;
+} DistanceTableFileHeader;
+
+// Length to a target left by its backward search in the bucket of a vertex
+typedef struct BucketEntry
+{
+	int target_num; // Index in the targets array
+	int length;
+} BucketEntry;
+
+// Buckets of all the vertexes, stored contiguously (compressed rows):
+// the bucket of v is entries[offsets[v]] ... entries[offsets[v + 1] - 1]
+typedef struct VertexBuckets
+{
+	int nb_vertexes;
+	int nb_targets;
+	long* offsets;
+	BucketEntry* entries;
+
+	// Every vertex at a length <= radiuses[t] from the target t is in the buckets
+	long* radiuses;
+} VertexBuckets;
+
+// Shortest path lengths from each source to each target
+typedef struct DistanceTable
+{
+	int nb_sources;
+	int nb_targets;
+	int* sources;
+	int* targets;
+	int* lengths; // lengths[i * nb_targets + j]: from sources[i] to targets[j]
+} DistanceTable;
+
+// Work shared by the threads of a phase (defined in distance_table.c)
+typedef struct DistanceTableState DistanceTableState;
+
+//------------------------------------------------------------------------------
+
+int computeDefaultBucketBudget (int nb_vertexes, int nb_targets);
+
+void runBackwardSearches (int thread_num, int nb_threads, void* state);
+void buildVertexBuckets (DistanceTableState* state);
+void freeVertexBuckets (VertexBuckets* buckets);
+
+long scanVertexBucket (VertexBuckets* buckets, int vertex, long length, long* row);
+long computeStoppingLength (VertexBuckets* buckets, long* row);
+void runForwardSearch (Graph* g, int source_num, DistanceTableState* state,
+					   DijkstraWorkspace* workspace, long* row);
+void runForwardSearches (int thread_num, int nb_threads, void* state);
+
+DistanceTable* computeDistanceTable (Graph* g, int* sources, int nb_sources,
+									 int* targets, int nb_targets,
+									 int bucket_budget, int nb_threads);
+void freeDistanceTable (DistanceTable* table);
+void writeDistanceTable (FILE* file, DistanceTable* table);
+
+#endif
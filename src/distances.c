@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+// DISTANCE TABLE TOOL
+//------------------------------------------------------------------------------
+// Computation of the lengths between a set of sources and a set of targets of
+// a graph (bucket-based many-to-many algorithm, see distance_table.c), written
+// in a binary file (format described in distance_table.h).
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "toolbox.h"
+#include "graph.h"
+#include "parallel.h"
+#include "distance_table.h"
+#include "distances.h"
+
+// Vertexes of a comma-separated list ("3,8,12"), or all the vertexes
+// (ALL_VERTEXES_LIST); exits if a vertex is invalid
+int* parseVertexList (char* list, int nb_vertexes, int* nb_listed_vertexes)
+{
+	if (strcmp(list, ALL_VERTEXES_LIST) == 0)
+	{
+		int* vertexes = malloc((nb_vertexes + 1) * sizeof(int));
+		CHECK_MALLOC(vertexes);
+
+		for (int i = 0; i < nb_vertexes; i++)
+			vertexes[i] = i;
+
+		*nb_listed_vertexes = nb_vertexes;
+		return vertexes;
+	}
+
+	// There are as many vertexes as commas, plus one
+	int nb_vertexes_in_list = 1;
+	for (char* c = list; *c != '\0'; c++)
+		if (*c == ',')
+			nb_vertexes_in_list++;
+
+	int* vertexes = malloc(nb_vertexes_in_list * sizeof(int));
+	CHECK_MALLOC(vertexes);
+
+	char* position = list;
+	for (int i = 0; i < nb_vertexes_in_list; i++)
+	{
+		int nb_read_chars = 0;
+		if (sscanf(position, "%d%n", &vertexes[i], &nb_read_chars) != 1
+		||  vertexes[i] < 0 || vertexes[i] >= nb_vertexes
+		||  (position[nb_read_chars] != ',' && position[nb_read_chars] != '\0'))
+		{
+			fprintf(stderr, "Error: invalid vertex list %s.\n", list);
+			exit(1);
+		}
+
+		position += nb_read_chars + 1;
+	}
+
+	*nb_listed_vertexes = nb_vertexes_in_list;
+	return vertexes;
+}
+
+//------------------------------------------------------------------------------
+// MAIN PROGRAM
+//------------------------------------------------------------------------------
+
+void printUsageAndExit (char* argv[])
+{
+	fprintf(stderr,
+			"Usage: %s <graph file> <output file> <sources> <targets> "
+			"[nb threads] [bucket budget]\n"
+			"Sources and targets are comma-separated vertexes, or \"%s\".\n",
+			argv[0], ALL_VERTEXES_LIST);
+	exit(1);
+}
+
+int main (int argc, char* argv[])
+{
+	// Try to get the arguments; print usage and exit if it fails
+	if (argc < 1 + 4 || argc > 1 + 6)
+		printUsageAndExit(argv);
+
+	char* graph_path  = argv[1];
+	char* output_path = argv[2];
+	int nb_threads 	  = getNbAvailableCores();
+	int bucket_budget = 0; // Default budget
+
+	int nb_read_values = 0;
+	if (argc > 5)
+		nb_read_values += sscanf(argv[5], "%d", &nb_threads);
+	if (argc > 6)
+		nb_read_values += sscanf(argv[6], "%d", &bucket_budget);
+
+	if (nb_read_values != argc - 5)
+		printUsageAndExit(argv);
+	if (nb_threads < 1 || bucket_budget < 0)
+		printUsageAndExit(argv);
+
+	// Read the graph
+	FILE* graph_file = fopen(graph_path, "r");
+	if (graph_file == NULL)
+	{
+		fprintf(stderr, "Error: graph file %s cannot be opened.\n", graph_path);
+		exit(1);
+	}
+
+	Graph* graph = createGraphFromFile(graph_file);
+	fclose(graph_file);
+
+	int nb_sources, nb_targets;
+	int* sources = parseVertexList(argv[3], graph->nb_vertexes, &nb_sources);
+	int* targets = parseVertexList(argv[4], graph->nb_vertexes, &nb_targets);
+
+	// Compute the table, and write it
+	DistanceTable* table = computeDistanceTable(graph, sources, nb_sources,
+												targets, nb_targets,
+												bucket_budget, nb_threads);
+
+	FILE* output_file = fopen(output_path, "wb");
+	if (output_file == NULL)
+	{
+		fprintf(stderr, "Error: output file %s cannot be opened.\n", output_path);
+		exit(1);
+	}
+
+	writeDistanceTable(output_file, table);
+	fclose(output_file);
+
+	//---------- Cleaning ----------
+
+	freeDistanceTable(table);
+	free(sources);
+	free(targets);
+	freeGraph(graph);
+
+	return 0;
+}
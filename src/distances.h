@@ -0,0 +1,18 @@
+//------------------------------------------------------------------------------
+// DISTANCE TABLE TOOL
+//------------------------------------------------------------------------------
+
+#ifndef _DISTANCES_H
+#define _DISTANCES_H
+
+#include "graph.h"
+
+// Vertex list standing for all the vertexes of the graph
+#define ALL_VERTEXES_LIST "all"
+
+//------------------------------------------------------------------------------
+
+int* parseVertexList (char* list, int nb_vertexes, int* nb_listed_vertexes);
+void printUsageAndExit (char* argv[]);
+
+#endif
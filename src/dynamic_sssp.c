@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+// DYNAMIC SINGLE-SOURCE SHORTEST PATHS
+//------------------------------------------------------------------------------
+// Shortest-path tree (lengths + parents) from a source, repaired after edge
+// weight changes instead of being recomputed from scratch (in the spirit of
+// Ramalingam & Reps' algorithm):
+// - when the weight of a tree edge increases, only the subtree below it is
+//   affected: its vertexes are relabeled from their unaffected neighbours;
+// - when the weight of an edge decreases, its endpoints may be improved;
+// then the improvements are propagated with a Dijkstra-like loop, which only
+// visits the vertexes whose length actually changes.
+// Updates can be given in batches, so that the propagation is done once.
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "toolbox.h"
+#include "graph.h"
+#include "fibonacci_heap.h"
+#include "dijkstra.h"
+#include "dynamic_sssp.h"
+
+//------------------------------------------------------------------------------
+// BASIC OPERATIONS
+//------------------------------------------------------------------------------
+
+// The initial tree is computed with the propagation loop, from the source only
+DynamicSSSP* createDynamicSSSP (Graph* g, int s)
+{
+	int nb_vertexes = g->nb_vertexes;
+
+	DynamicSSSP* sssp = malloc(sizeof(DynamicSSSP));
+	CHECK_MALLOC(sssp);
+
+	sssp->graph  = g;
+	sssp->source = s;
+
+	sssp->lengths 			= malloc(nb_vertexes * sizeof(int));
+	sssp->parents 			= malloc(nb_vertexes * sizeof(int));
+	sssp->is_affected 		= malloc(nb_vertexes * sizeof(bool));
+	sssp->affected_vertexes = malloc(nb_vertexes * sizeof(int));
+	sssp->nodes 			= malloc(nb_vertexes * sizeof(Node));
+	sssp->is_in_heap 		= malloc(nb_vertexes * sizeof(bool));
+	CHECK_MALLOC(sssp->lengths);
+	CHECK_MALLOC(sssp->parents);
+	CHECK_MALLOC(sssp->is_affected);
+	CHECK_MALLOC(sssp->affected_vertexes);
+	CHECK_MALLOC(sssp->nodes);
+	CHECK_MALLOC(sssp->is_in_heap);
+
+	for (int i = 0; i < nb_vertexes; i++)
+	{
+		sssp->lengths[i] 	 = INF_LENGTH;
+		sssp->parents[i] 	 = -1;
+		sssp->is_affected[i] = false;
+		sssp->is_in_heap[i]  = false;
+	}
+
+	sssp->nb_affected_vertexes = 0;
+	initFiboHeap(&sssp->fibo_heap);
+
+	improveVertexLength(sssp, s, 0, -1);
+	propagateImprovements(sssp);
+
+	return sssp;
+}
+
+void freeDynamicSSSP (DynamicSSSP* sssp)
+{
+	free(sssp->lengths);
+	free(sssp->parents);
+	free(sssp->is_affected);
+	free(sssp->affected_vertexes);
+	free(sssp->nodes);
+	free(sssp->is_in_heap);
+
+	free(sssp);
+}
+
+//------------------------------------------------------------------------------
+// TREE REPAIR
+//------------------------------------------------------------------------------
+
+// Give a vertex a new length (and parent) if it is shorter than its current one,
+// and (re)schedule it in the heap
+void improveVertexLength (DynamicSSSP* sssp, int vertex, int length, int parent)
+{
+	if (sssp->lengths[vertex] != INF_LENGTH
+	&&  sssp->lengths[vertex] <= length)
+		return;
+
+	sssp->lengths[vertex] = length;
+	sssp->parents[vertex] = parent;
+
+	Node* node = &sssp->nodes[vertex];
+	if (sssp->is_in_heap[vertex])
+		decreaseKeyInFiboHeap(&sssp->fibo_heap, node, length);
+	else
+	{
+		initIsolatedNode(node, vertex, length);
+		insertRootInFiboHeap(&sssp->fibo_heap, node);
+		sssp->is_in_heap[vertex] = true;
+	}
+}
+
+// Dijkstra-like loop over the scheduled vertexes
+void propagateImprovements (DynamicSSSP* sssp)
+{
+	FiboHeap* fibo_heap = &sssp->fibo_heap;
+
+	while (fibo_heap->min_element != NULL)
+	{
+		Node* extracted_min = extractMinFromFiboHeap(fibo_heap);
+		int vertex = extracted_min->value;
+		sssp->is_in_heap[vertex] = false;
+
+		int length = sssp->lengths[vertex];
+		for (Edge* edge = sssp->graph->edges[vertex]; edge != NULL; edge = edge->next)
+			improveVertexLength(sssp, edge->destination, length + edge->weight, vertex);
+	}
+}
+
+// Mark all the vertexes of the subtree rooted in root as affected
+// The list of affected vertexes is used as the queue of the traversal:
+// the children of a vertex are its neighbours having it as parent
+void markAffectedSubtree (DynamicSSSP* sssp, int root)
+{
+	if (sssp->is_affected[root])
+		return;
+
+	int first_new_vertex = sssp->nb_affected_vertexes;
+	sssp->is_affected[root] = true;
+	sssp->affected_vertexes[(sssp->nb_affected_vertexes)++] = root;
+
+	for (int i = first_new_vertex; i < sssp->nb_affected_vertexes; i++)
+	{
+		int vertex = sssp->affected_vertexes[i];
+
+		for (Edge* edge = sssp->graph->edges[vertex]; edge != NULL; edge = edge->next)
+		{
+			int neighbour = edge->destination;
+
+			if (sssp->parents[neighbour] == vertex
+			&&  ! sssp->is_affected[neighbour])
+			{
+				sssp->is_affected[neighbour] = true;
+				sssp->affected_vertexes[(sssp->nb_affected_vertexes)++] = neighbour;
+			}
+		}
+	}
+}
+
+// Forget the lengths of the affected vertexes, and compute new (upper bound)
+// lengths from their unaffected neighbours
+void relabelAffectedVertexes (DynamicSSSP* sssp)
+{
+	for (int i = 0; i < sssp->nb_affected_vertexes; i++)
+	{
+		int vertex = sssp->affected_vertexes[i];
+
+		sssp->lengths[vertex] = INF_LENGTH;
+		sssp->parents[vertex] = -1;
+	}
+
+	for (int i = 0; i < sssp->nb_affected_vertexes; i++)
+	{
+		int vertex = sssp->affected_vertexes[i];
+
+		for (Edge* edge = sssp->graph->edges[vertex]; edge != NULL; edge = edge->next)
+		{
+			int neighbour = edge->destination;
+
+			if (! sssp->is_affected[neighbour]
+			&&  sssp->lengths[neighbour] != INF_LENGTH)
+				improveVertexLength(sssp, vertex, sssp->lengths[neighbour] + edge->weight,
+									neighbour);
+		}
+	}
+
+	for (int i = 0; i < sssp->nb_affected_vertexes; i++)
+		sssp->is_affected[sssp->affected_vertexes[i]] = false;
+	sssp->nb_affected_vertexes = 0;
+}
+
+//------------------------------------------------------------------------------
+// UPDATES
+//------------------------------------------------------------------------------
+
+// The whole batch is checked before any weight is changed, so that an invalid
+// update (unknown edge, or negative weight) leaves the graph and the tree intact
+void checkEdgeWeightUpdates (Graph* g, EdgeWeightUpdate* updates, int nb_updates)
+{
+	for (int i = 0; i < nb_updates; i++)
+	{
+		int origin 		= updates[i].origin;
+		int destination = updates[i].destination;
+		int weight;
+
+		if (origin < 0 || origin >= g->nb_vertexes
+		||  destination < 0 || destination >= g->nb_vertexes
+		||  !getEdgeWeight(g, origin, destination, &weight))
+		{
+			fprintf(stderr, "Error: update of a missing edge (%d, %d).\n", origin, destination);
+			exit(1);
+		}
+
+		if (updates[i].new_weight < 0)
+		{
+			fprintf(stderr, "Error: negative weight %d for the edge (%d, %d).\n",
+					updates[i].new_weight, origin, destination);
+			exit(1);
+		}
+	}
+}
+
+void applyEdgeWeightUpdates (DynamicSSSP* sssp, EdgeWeightUpdate* updates, int nb_updates)
+{
+	int* lengths = sssp->lengths;
+	int* parents = sssp->parents;
+
+	checkEdgeWeightUpdates(sssp->graph, updates, nb_updates);
+
+	// 1. All the new weights are set in the graph
+	for (int i = 0; i < nb_updates; i++)
+		setUndirectedEdgeWeight(sssp->graph, updates[i].origin,
+								updates[i].destination, updates[i].new_weight);
+
+	// 2. Tree edges which became heavier than the tree assumes cut their subtree
+	for (int i = 0; i < nb_updates; i++)
+	{
+		int origin 		= updates[i].origin;
+		int destination = updates[i].destination;
+		int weight;
+		getEdgeWeight(sssp->graph, origin, destination, &weight);
+
+		if (parents[destination] == origin
+		&&  weight > lengths[destination] - lengths[origin])
+			markAffectedSubtree(sssp, destination);
+
+		else if (parents[origin] == destination
+			 &&  weight > lengths[origin] - lengths[destination])
+			markAffectedSubtree(sssp, origin);
+	}
+
+	relabelAffectedVertexes(sssp);
+
+	// 3. Edges which became lighter may improve their endpoints
+	for (int i = 0; i < nb_updates; i++)
+	{
+		int origin 		= updates[i].origin;
+		int destination = updates[i].destination;
+		int weight;
+		getEdgeWeight(sssp->graph, origin, destination, &weight);
+
+		if (lengths[origin] != INF_LENGTH)
+			improveVertexLength(sssp, destination, lengths[origin] + weight, origin);
+		if (lengths[destination] != INF_LENGTH)
+			improveVertexLength(sssp, origin, lengths[destination] + weight, destination);
+	}
+
+	// 4. The changes are propagated
+	propagateImprovements(sssp);
+}
+
+void updateEdgeWeight (DynamicSSSP* sssp, int origin, int destination, int new_weight)
+{
+	EdgeWeightUpdate update;
+	update.origin 	   = origin;
+	update.destination = destination;
+	update.new_weight  = new_weight;
+
+	applyEdgeWeightUpdates(sssp, &update, 1);
+}
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+// DYNAMIC SINGLE-SOURCE SHORTEST PATHS
+//------------------------------------------------------------------------------
+
+#ifndef _DYNAMIC_SSSP_H
+#define _DYNAMIC_SSSP_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "fibonacci_heap.h"
+
+// New weight of all the edges between two vertexes
+typedef struct EdgeWeightUpdate
+{
+	int origin;
+	int destination;
+	int new_weight;
+} EdgeWeightUpdate;
+
+// Shortest-path tree from a source, maintained under edge weight updates
+typedef struct DynamicSSSP
+{
+	Graph* graph;
+	int source;
+
+	// Lengths (INF_LENGTH if unreachable) and parents in the tree (-1 if none)
+	int* lengths;
+	int* parents;
+
+	// Memory used to repair the tree
+	bool* is_affected;
+	int* affected_vertexes;
+	int nb_affected_vertexes;
+
+	FiboHeap fibo_heap;
+	Node* nodes;
+	bool* is_in_heap;
+} DynamicSSSP;
+
+//------------------------------------------------------------------------------
+
+DynamicSSSP* createDynamicSSSP (Graph* g, int s);
+void freeDynamicSSSP (DynamicSSSP* sssp);
+
+void improveVertexLength (DynamicSSSP* sssp, int vertex, int length, int parent);
+void propagateImprovements (DynamicSSSP* sssp);
+void markAffectedSubtree (DynamicSSSP* sssp, int root);
+void relabelAffectedVertexes (DynamicSSSP* sssp);
+
+void checkEdgeWeightUpdates (Graph* g, EdgeWeightUpdate* updates, int nb_updates);
+void applyEdgeWeightUpdates (DynamicSSSP* sssp, EdgeWeightUpdate* updates, int nb_updates);
+void updateEdgeWeight (DynamicSSSP* sssp, int origin, int destination, int new_weight);
+
+#endif
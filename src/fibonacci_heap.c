@@ -17,32 +17,45 @@
 // Basic operations on nodes
 //------------------------------------------------------------------------------
 
+// Initialize the fields of an (already allocated) node
+void initNode (Node* node, NodeValue value, int key)
+{
+	node->next 		= NULL;
+	node->previous 	= NULL;
+	node->father 	= NULL;
+	node->child 	= NULL;
+	node->value 	= value;
+	node->key 		= key;
+	node->degree 	= 0;
+	node->is_tagged = false;
+}
+
+// Initialize an (already allocated) node as an isolated node (first of a CDLL)
+void initIsolatedNode (Node* node, NodeValue value, int key)
+{
+	initNode(node, value, key);
+
+	node->next 	   = node;
+	node->previous = node;
+}
+
 // Returns a pointer to a new node
 Node* createNode (NodeValue value, int key)
 {
 	Node* new_node = malloc(sizeof(Node));
 	CHECK_MALLOC(new_node)
 
-	new_node->next 		= NULL;
-	new_node->previous 	= NULL;
-	new_node->father 	= NULL;
-	new_node->child 	= NULL;
-	new_node->value 	= value;
-	new_node->key 		= key;
-	new_node->degree 	= 0;
-	new_node->is_tagged = false;
-
+	initNode(new_node, value, key);
 	return new_node;
 }
 
 // Returns a pointer to a new, isolated node (first of a CDLL)
 Node* createIsolatedNode (NodeValue value, int key)
 {
-	Node* new_isolated_node = createNode(value, key);
-
-	new_isolated_node->next 	= new_isolated_node;
-	new_isolated_node->previous = new_isolated_node;
+	Node* new_isolated_node = malloc(sizeof(Node));
+	CHECK_MALLOC(new_isolated_node)
 
+	initIsolatedNode(new_isolated_node, value, key);
 	return new_isolated_node;
 }
 
@@ -131,16 +144,22 @@ void printListOfNodes (Node* node)
 // Basic operations on Fibonacci heaps
 //------------------------------------------------------------------------------
 
+// Initialize an (already allocated) Fibonacci heap as an empty one
+// The nodes it may have contained are not freed
+void initFiboHeap (FiboHeap* fibo_heap)
+{
+	fibo_heap->min_element 	= NULL;
+	fibo_heap->degree 		= 0;
+	fibo_heap->nb_nodes 	= 0;
+}
+
 // Returns a pointer to a new, empty Fibonacci heap
 FiboHeap* createFiboHeap ()
 {
 	FiboHeap* new_fibo_heap = malloc(sizeof(FiboHeap));
 	CHECK_MALLOC(new_fibo_heap)
 
-	new_fibo_heap->min_element 	= NULL;
-	new_fibo_heap->degree 		= 0;
-	new_fibo_heap->nb_nodes 	= 0;
-
+	initFiboHeap(new_fibo_heap);
 	return new_fibo_heap;
 }
 
@@ -350,47 +369,26 @@ void consolidateFiboHeap (FiboHeap* fibo_heap)
 	assert(fibo_heap->min_element != NULL);
 
 	// Create an array of nodes indexed on degrees
-	// The highest reachable degree is related to the total number of nodes...
-	Node* roots_of_degree[fibo_heap->nb_nodes];
-	for (unsigned int i = 0; i <= fibo_heap->nb_nodes; i++)
+	// The degree of a node is logarithmic in the number of nodes, so a fixed-size
+	// array is enough (and no allocation proportional to the heap is required)
+	Node* roots_of_degree[MAX_FIBO_HEAP_DEGREE];
+	for (unsigned int i = 0; i < MAX_FIBO_HEAP_DEGREE; i++)
 		roots_of_degree[i] = NULL;
 
-	// The loop iterates over the number of root nodes, but it will be repeated
-	// endlessy until there has been an iteration with no change, meaning the
-	// Fibonacci heap has been consolidated (no two roots of the same degree)
-
-	// Current node being processed in the loop, and auxiliary (next) node
-	Node* current_node = fibo_heap->min_element;
-	Node* next_node;
-
-	// Variables used to control the upcoming loop
-	unsigned int nb_roots 		  = fibo_heap->degree;
-	unsigned int nb_visited_roots = 0;
-	bool node_has_been_linked 	  = false;
+	// Each initial root is visited once; the next root is saved before the
+	// current one is possibly linked (and thus removed from the roots' CDLL)
+	Node* current_root = fibo_heap->min_element;
+	Node* next_root;
+	unsigned int nb_roots = fibo_heap->degree;
 
-	while (nb_visited_roots <= nb_roots
-	   ||  node_has_been_linked)
+	for (unsigned int i = 0; i < nb_roots; i++)
 	{
-		// Reset the control variable(s)
-		if (nb_visited_roots > nb_roots)
-		{
-			nb_visited_roots = 0;
-			node_has_been_linked = false;
-		}
-/*
-		printf("\n\nWhile 1: %d/%d [current_node info] ", nb_visited_roots, nb_roots);
-		printNodeDetails(current_node);
-		printFiboHeap(fibo_heap);
-*/
-		// Next node of the current one
-		next_node = current_node->next;
-
-		// Initial degree of the current iteration
+		next_root = current_root->next;
+
+		Node* current_node = current_root;
 		unsigned int current_degree = current_node->degree;
 
-		while (roots_of_degree[current_degree] != NULL
-		   &&  roots_of_degree[current_degree] != current_node
-		   /*&&  current_node->father == NULL*/)
+		while (roots_of_degree[current_degree] != NULL)
 		{
 			// Root node having the same degree
 			Node* current_degree_root = roots_of_degree[current_degree];
@@ -401,57 +399,32 @@ void consolidateFiboHeap (FiboHeap* fibo_heap)
 				Node* current_node_copy = current_node;
 				current_node 			= current_degree_root;
 				current_degree_root 	= current_node_copy;
-
-				// Update the next node to visit to reflect this inversion
-				// next_node = current_node->next;		
 			}
-/*
-			printf("\nAvant insertion:\n");
-			printNodeDetails(current_node);
-			printListOfNodes(current_node->child);
-			// printNodeDetails(current_degree_root);
-*/
+
 			linkRootNodes(fibo_heap, current_degree_root, current_node);
-/*
-			printf("\nAprès insertion:\n");
-			printNodeDetails(current_node);
-			printListOfNodes(current_node->child);
-*/
+
 			// The current degree don't have any associated node anymore,
 			// but the next degree must be checked
 			roots_of_degree[current_degree] = NULL;
 			current_degree++;
-
-			// Update of the control variables
-			node_has_been_linked = true;
-			// nb_roots--;
+			assert(current_degree < MAX_FIBO_HEAP_DEGREE);
 		}
 
 		// Set current_node as the only node of current_degree
 		roots_of_degree[current_degree] = current_node;
 
-		// The next root becomes the new current one
-		// current_node = next_node;
-	current_node = current_node->next;
-
-		// BUG HERE: This assertion should never fail, but sometimes do!
-		assert(current_node->father == NULL);
-
-		// Update of the control variables
-		nb_visited_roots++;
+		current_root = next_root;
 	}
 
 	// The actual min element of the Fibonacci heap is finally updated
-	for (unsigned int i = 0; i < fibo_heap->nb_nodes; i++)
+	fibo_heap->min_element = NULL;
+	for (unsigned int i = 0; i < MAX_FIBO_HEAP_DEGREE; i++)
 		if (roots_of_degree[i] != NULL)
 		{
-			if (roots_of_degree[i]->key < fibo_heap->min_element->key)
+			if (fibo_heap->min_element == NULL
+			||  roots_of_degree[i]->key < fibo_heap->min_element->key)
 				fibo_heap->min_element = roots_of_degree[i];
 		}
-
-	// printf("\nFin de la consolidation :\n");
-	// printFiboHeap(fibo_heap);
-	// printf("----------------------------------------------------------\n");
 }
 
 Node* extractMinFromFiboHeap (FiboHeap* fibo_heap)
@@ -463,22 +436,12 @@ Node* extractMinFromFiboHeap (FiboHeap* fibo_heap)
 		return NULL;
 
 	// If it exists, all its children (if any) become new roots of the heap
-	Node* current_child 	 = min_element->child;
-	unsigned int nb_children = min_element->degree;
-
-/*
-	printf("\nExtract min (%p : %d) of degree %d\n",
-		(void*) min_element, min_element->key, min_element->degree);
-*/
-
-	for (unsigned int i = 0; i < nb_children; i++)
+	while (min_element->child != NULL)
 	{
-		current_child = current_child->next;
-		moveSubHeapToRoot(fibo_heap, current_child->previous);
-/*
-		printf("Liste enfants après extraction %d (extract min):\n", i);
-		printListOfNodes(current_child);
-*/
+		Node* current_child = min_element->child;
+
+		moveSubHeapToRoot(fibo_heap, current_child);
+		current_child->is_tagged = false;
 	}
 
 	// The minimum element is extracted from the roots
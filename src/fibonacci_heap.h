@@ -8,6 +8,9 @@
 #include "toolbox.h"
 #include <stdbool.h>
 
+// Upper bound of the degree of any node (it is logarithmic in the number of nodes)
+#define MAX_FIBO_HEAP_DEGREE 64
+
 // Type of the value of a node of the Fibonacci heap
 typedef int NodeValue;
 
@@ -44,6 +47,8 @@ typedef struct FiboHeap {
 
 //------------------------------------------------------------------------------
 
+void initNode (Node* node, NodeValue value, int key);
+void initIsolatedNode (Node* node, NodeValue value, int key);
 Node* createNode (NodeValue value, int key);
 Node* createIsolatedNode (NodeValue value, int key);
 void freeNode (Node* node);
@@ -51,6 +56,7 @@ void freeNodeTree (Node* root);
 void printNodeDetails (Node* node);
 void printListOfNodes (Node* node);
 
+void initFiboHeap (FiboHeap* fibo_heap);
 FiboHeap* createFiboHeap ();
 void freeFiboHeap (FiboHeap* fibo_heap);
 void printFiboHeap (FiboHeap* fibo_heap);
@@ -2,17 +2,54 @@
 // GRAPH
 //------------------------------------------------------------------------------
 // Implementation of a graph structure
-// Includes reading from file + checking connectivity.
+// Includes reading from file + checking connectivity (see connectivity.c)
+// + breadth-first search (hop counts).
 //------------------------------------------------------------------------------
 
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
-#include "list.h"
+#include <limits.h>
+#include <stdint.h>
 #include "toolbox.h"
 #include "complexity.h"
+#include "list.h"
+#include "parallel.h"
 #include "graph.h"
+#include "connectivity.h"
+
+// Thresholds of the direction-optimizing BFS (Beamer et al.):
+// - top-down to bottom-up when the frontier has more than 1/ALPHA of the
+//   edges left to check
+// - bottom-up to top-down when the frontier shrinks below 1/BETA of the
+//   vertexes
+#define BFS_ALPHA 15
+#define BFS_BETA  18
+
+// State shared by the threads of a direction-optimizing breadth-first search
+struct BFSState
+{
+	Graph* graph;
+	int* depths; // Updated atomically by the top-down steps
+	int current_depth;
+
+	// Sparse frontier (top-down steps), and next frontier found by each thread
+	int* frontier;
+	int frontier_size;
+	Stack* next_frontiers;
+
+	// Dense frontiers (bottom-up steps): one bit per vertex
+	uint64_t* frontier_bitmap;
+	uint64_t* next_frontier_bitmap;
+	int nb_bitmap_words;
+
+	// Per-thread sizes of the next frontier (in vertexes, and in edges: sum of
+	// the degrees of its vertexes)
+	int* nb_awake_vertexes;
+	long* nb_scouted_edges;
+};
 
 //------------------------------------------------------------------------------
 // BASIC OPERATIONS
@@ -39,16 +76,55 @@ Graph* createEmptyGraph (int nb_vertexes)
 	CHECK_MALLOC(new_graph);
 
 	new_graph->nb_vertexes = nb_vertexes;
+	new_graph->nb_edges    = 0;
+	new_graph->min_weight  = INT_MAX;
+	new_graph->max_weight  = INT_MIN;
+	new_graph->nb_components = nb_vertexes;
 	
-	new_graph->edges = malloc(nb_vertexes * sizeof(Edge*));
+	new_graph->edges   = malloc(nb_vertexes * sizeof(Edge*));
+	new_graph->degrees = calloc(nb_vertexes + 1, sizeof(int));
+	CHECK_MALLOC(new_graph->degrees);
 	for (int i = 0; i < nb_vertexes; i++)
 		new_graph->edges[i] = NULL;
 
 	return new_graph;
 }
 
+void freeGraph (Graph* graph)
+{
+	for (int i = 0; i < graph->nb_vertexes; i++)
+	{
+		Edge* edge = graph->edges[i];
+		while (edge != NULL)
+		{
+			Edge* next_edge = edge->next;
+			free(edge);
+			edge = next_edge;
+		}
+	}
+
+	free(graph->edges);
+	free(graph->degrees);
+	free(graph);
+}
+
+void updateWeightBounds (Graph* graph, int weight)
+{
+	if (weight < graph->min_weight)
+		graph->min_weight = weight;
+	if (weight > graph->max_weight)
+		graph->max_weight = weight;
+}
+
 void addUndirectedEdgeToGraph (Graph* graph, int origin, int destination, int weight)
 {
+	updateWeightBounds(graph, weight);
+	graph->nb_components = UNKNOWN_NB_COMPONENTS;
+
+	(graph->nb_edges)++;
+	(graph->degrees[origin])++;
+	(graph->degrees[destination])++;
+
 	// Add an edge from the origin to the destination
 	Edge* current_source_edge = graph->edges[origin];
 
@@ -63,7 +139,64 @@ void addUndirectedEdgeToGraph (Graph* graph, int origin, int destination, int we
 	graph->edges[destination] = new_destination_edge;
 }
 
-Graph* createGraphFromFile (FILE* file)
+// Set the weight of all the edges between two vertexes (both ways)
+// Returns false if there is no such edge
+bool setUndirectedEdgeWeight (Graph* graph, int origin, int destination, int weight)
+{
+	bool edge_found = false;
+
+	for (Edge* edge = graph->edges[origin]; edge != NULL; edge = edge->next)
+		if (edge->destination == destination)
+		{
+			edge->weight = weight;
+			edge_found 	 = true;
+		}
+
+	for (Edge* edge = graph->edges[destination]; edge != NULL; edge = edge->next)
+		if (edge->destination == origin)
+			edge->weight = weight;
+
+	if (edge_found)
+		updateWeightBounds(graph, weight);
+
+	return edge_found;
+}
+
+// Gives the weight of the first edge from origin to destination
+// Returns false (and leaves weight untouched) if there is no such edge
+bool getEdgeWeight (Graph* graph, int origin, int destination, int* weight)
+{
+	for (Edge* edge = graph->edges[origin]; edge != NULL; edge = edge->next)
+		if (edge->destination == destination)
+		{
+			*weight = edge->weight;
+			return true;
+		}
+
+	return false;
+}
+
+GraphEdgeArray* createGraphEdgeArray (int nb_vertexes, int nb_edges)
+{
+	GraphEdgeArray* edge_array = malloc(sizeof(GraphEdgeArray));
+	CHECK_MALLOC(edge_array);
+
+	edge_array->nb_vertexes  = nb_vertexes;
+	edge_array->nb_edges 	 = nb_edges;
+	edge_array->origins 	 = malloc((nb_edges + 1) * sizeof(int));
+	edge_array->destinations = malloc((nb_edges + 1) * sizeof(int));
+	edge_array->weights 	 = malloc((nb_edges + 1) * sizeof(int));
+	CHECK_MALLOC(edge_array->origins);
+	CHECK_MALLOC(edge_array->destinations);
+	CHECK_MALLOC(edge_array->weights);
+
+	return edge_array;
+}
+
+// Read the edges of a graph file, and merge their ends in a union-find
+// structure as they are read: the number of components is known at the end
+// of the parsing, without building the adjacency lists
+GraphEdgeArray* readGraphEdgesFromTextFile (FILE* file)
 {
 	// The first line contains:
 	// - the number of vertexes
@@ -71,14 +204,14 @@ Graph* createGraphFromFile (FILE* file)
 	int nb_vertexes, nb_edges;
 
 	int nb_var_read = fscanf(file, "%d %d", &nb_vertexes, &nb_edges);
-	if (nb_var_read != 2)
+	if (nb_var_read != 2 || nb_vertexes < 0 || nb_edges < 0)
 	{
 		fprintf(stderr, "Error: graph file has a bad syntax.\n");
 		exit(1);
 	}
 
-	// Create an empty graph of nb_vertexes vertexes
-	Graph* new_graph = createEmptyGraph(nb_vertexes);
+	GraphEdgeArray* edge_array = createGraphEdgeArray(nb_vertexes, nb_edges);
+	UnionFind* union_find = createUnionFind(nb_vertexes);
 
 	// Then, there are nb_edges lines. Each line contains :
 	// - an origin
@@ -89,16 +222,186 @@ Graph* createGraphFromFile (FILE* file)
 	for (int line = 0; line < nb_edges; line++)
 	{
 		nb_var_read = fscanf(file, "%d %d %d", &origin, &destination, &weight);
-		if (nb_var_read != 3)
+		if (nb_var_read != 3
+		||  origin < 0 || origin >= nb_vertexes
+		||  destination < 0 || destination >= nb_vertexes)
 		{
 			fprintf(stderr, "Error: graph file has a bad syntax.\n");
 			exit(1);
 		}
 
-		// Add the edges (both ways) to the graph
-		addUndirectedEdgeToGraph(new_graph, origin, destination, weight);
+		edge_array->origins[line] 	   = origin;
+		edge_array->destinations[line] = destination;
+		edge_array->weights[line] 	   = weight;
+
+		mergeSets(union_find, origin, destination);
+	}
+
+	edge_array->nb_components = union_find->nb_sets;
+	freeUnionFind(union_find);
+
+	return edge_array;
+}
+
+// Same as readGraphEdgesFromTextFile(), for a binary graph file: every edge is
+// read from the adjacency of its end with the larger number
+GraphEdgeArray* readGraphEdgesFromBinaryFile (FILE* file)
+{
+	GraphFileHeader header;
+
+	if (fread(&header, sizeof(header), 1, file) != 1
+	||  memcmp(header.magic, GRAPH_FILE_MAGIC, 4) != 0
+	||  header.nb_vertexes < 0
+	||  header.nb_edges < 0 || header.nb_edges > INT_MAX)
+	{
+		fprintf(stderr, "Error: binary graph file has a bad header.\n");
+		exit(1);
+	}
+
+	int nb_vertexes 	= header.nb_vertexes;
+	size_t nb_offsets 	= (size_t) nb_vertexes + 1;
+	size_t nb_edge_ends = 2 * (size_t) header.nb_edges;
+
+	int64_t* offsets 	  = malloc(nb_offsets * sizeof(int64_t));
+	int32_t* destinations = malloc((nb_edge_ends + 1) * sizeof(int32_t));
+	int32_t* weights 	  = malloc((nb_edge_ends + 1) * sizeof(int32_t));
+	CHECK_MALLOC(offsets);
+	CHECK_MALLOC(destinations);
+	CHECK_MALLOC(weights);
+
+	if (fread(offsets, sizeof(int64_t), nb_offsets, file) != nb_offsets
+	||  fread(destinations, sizeof(int32_t), nb_edge_ends, file) != nb_edge_ends
+	||  fread(weights, sizeof(int32_t), nb_edge_ends, file) != nb_edge_ends)
+	{
+		fprintf(stderr, "Error: binary graph file is truncated.\n");
+		exit(1);
+	}
+
+	GraphEdgeArray* edge_array = createGraphEdgeArray(nb_vertexes, (int) header.nb_edges);
+	UnionFind* union_find = createUnionFind(nb_vertexes);
+	int nb_edges = 0;
+	bool corrupted = offsets[0] != 0 || offsets[nb_vertexes] != (int64_t) nb_edge_ends;
+
+	for (int origin = 0; origin < nb_vertexes && !corrupted; origin++)
+	{
+		bool odd_loop = false;
+
+		if (offsets[origin + 1] < offsets[origin] || offsets[origin + 1] > (int64_t) nb_edge_ends)
+		{
+			corrupted = true;
+			break;
+		}
+
+		for (int64_t i = offsets[origin]; i < offsets[origin + 1]; i++)
+		{
+			int destination = destinations[i];
+
+			if (destination < 0 || destination >= nb_vertexes)
+				corrupted = true;
+			if (corrupted || destination > origin)
+				continue;
+
+			// Loops: only the first of their two occurrences is kept
+			if (destination == origin)
+			{
+				odd_loop = !odd_loop;
+				if (!odd_loop)
+					continue;
+			}
+
+			if (nb_edges == header.nb_edges)
+			{
+				corrupted = true;
+				break;
+			}
+
+			edge_array->origins[nb_edges] 	   = origin;
+			edge_array->destinations[nb_edges] = destination;
+			edge_array->weights[nb_edges] 	   = weights[i];
+			nb_edges++;
+
+			mergeSets(union_find, origin, destination);
+		}
+	}
+
+	if (corrupted || nb_edges != header.nb_edges)
+	{
+		fprintf(stderr, "Error: binary graph file is corrupted.\n");
+		exit(1);
 	}
 
+	edge_array->nb_components = union_find->nb_sets;
+	freeUnionFind(union_find);
+
+	free(offsets);
+	free(destinations);
+	free(weights);
+
+	return edge_array;
+}
+
+// The format is recognized from the first character (a text file starts with
+// the number of vertexes, a binary file with its magic number)
+GraphEdgeArray* readGraphEdgesFromFile (FILE* file)
+{
+	int first_character = getc(file);
+	ungetc(first_character, file);
+
+	if (first_character == GRAPH_FILE_MAGIC[0])
+		return readGraphEdgesFromBinaryFile(file);
+
+	return readGraphEdgesFromTextFile(file);
+}
+
+void freeGraphEdgeArray (GraphEdgeArray* edge_array)
+{
+	free(edge_array->origins);
+	free(edge_array->destinations);
+	free(edge_array->weights);
+
+	free(edge_array);
+}
+
+Graph* createGraphFromEdgeArray (GraphEdgeArray* edge_array)
+{
+	// Create an empty graph of nb_vertexes vertexes
+	Graph* new_graph = createEmptyGraph(edge_array->nb_vertexes);
+
+	// Add the edges (both ways) to the graph
+	for (int i = 0; i < edge_array->nb_edges; i++)
+		addUndirectedEdgeToGraph(new_graph, edge_array->origins[i],
+								 edge_array->destinations[i], edge_array->weights[i]);
+
+	// The components do not change when the edges are added back
+	new_graph->nb_components = edge_array->nb_components;
+
+	return new_graph;
+}
+
+Graph* createGraphFromFile (FILE* file)
+{
+	GraphEdgeArray* edge_array = readGraphEdgesFromFile(file);
+	Graph* new_graph = createGraphFromEdgeArray(edge_array);
+
+	freeGraphEdgeArray(edge_array);
+	return new_graph;
+}
+
+// Same as createGraphFromFile(), but the adjacency lists are only built if
+// the graph is connected (otherwise, NULL is returned)
+// The number of components is stored in nb_components (unless it is NULL)
+Graph* createConnectedGraphFromFile (FILE* file, int* nb_components)
+{
+	GraphEdgeArray* edge_array = readGraphEdgesFromFile(file);
+	Graph* new_graph = NULL;
+
+	if (nb_components != NULL)
+		*nb_components = edge_array->nb_components;
+
+	if (edge_array->nb_components <= 1)
+		new_graph = createGraphFromEdgeArray(edge_array);
+
+	freeGraphEdgeArray(edge_array);
 	return new_graph;
 }
 
@@ -106,50 +409,248 @@ Graph* createGraphFromFile (FILE* file)
 // GRAPH CONNECTIVITY
 //------------------------------------------------------------------------------
 
+// The graph is connected if it has a single connected component
+// (computed with a union-find, unless it is already known since the loading)
 bool graphIsConnected (Graph* g)
 {
-	List* waiting = createList();
-	addElementToList(waiting, 0);
-	COMPLEXITY = 9;
+	COMPLEXITY = 0;
 
-	bool seen[g->nb_vertexes];
-	COMPLEXITY += g->nb_vertexes;
+	if (g->nb_components == UNKNOWN_NB_COMPONENTS)
+		g->nb_components = countConnectedComponents(g);
 
-	for (int i = 0 ; i < g->nb_vertexes; i++)
-	{
-		seen[i] = false;
-		COMPLEXITY ++;
-	}
-	while (! listIsEmpty(waiting))
+	return g->nb_components <= 1;
+}
+
+//------------------------------------------------------------------------------
+// BREADTH-FIRST SEARCH
+//------------------------------------------------------------------------------
+// Direction-optimizing BFS: while the frontier is small, its vertexes look
+// for unvisited neighbours (top-down); once it holds a large part of the
+// edges, every unvisited vertex rather looks for a neighbour in the frontier
+// (bottom-up), and stops at the first one. On low-diameter graphs, most of the
+// edges are then never examined. Both kinds of steps are multithreaded.
+//------------------------------------------------------------------------------
+
+// Every frontier vertex visits its unvisited neighbours; a neighbour is
+// claimed by a single thread (compare-and-swap on its depth)
+void runTopDownStep (int thread_num, int nb_threads, void* argument)
+{
+	BFSState* state = argument;
+	Stack* next_frontier = &state->next_frontiers[thread_num];
+	int next_depth = state->current_depth + 1;
+	long nb_scouted_edges = 0;
+
+	int start = (int) (((long) state->frontier_size * thread_num) / nb_threads);
+	int end   = (int) (((long) state->frontier_size * (thread_num + 1)) / nb_threads);
+
+	next_frontier->size = 0;
+
+	for (int i = start; i < end; i++)
+		for (Edge* edge = state->graph->edges[state->frontier[i]]; edge != NULL; edge = edge->next)
+		{
+			int neighbour = edge->destination;
+			int depth = __atomic_load_n(&state->depths[neighbour], __ATOMIC_RELAXED);
+
+			if (depth == UNREACHED_DEPTH
+			&&  __atomic_compare_exchange_n(&state->depths[neighbour], &depth, next_depth,
+											false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				pushToStack(next_frontier, neighbour);
+				nb_scouted_edges += state->graph->degrees[neighbour];
+			}
+		}
+
+	state->nb_awake_vertexes[thread_num] = next_frontier->size;
+	state->nb_scouted_edges[thread_num]  = nb_scouted_edges;
+}
+
+// Every unvisited vertex looks for a neighbour in the frontier
+// Each thread owns whole words of the bitmaps: no atomic operation is needed
+void runBottomUpStep (int thread_num, int nb_threads, void* argument)
+{
+	BFSState* state = argument;
+	Graph* g = state->graph;
+	int next_depth = state->current_depth + 1;
+	int nb_awake_vertexes = 0;
+	long nb_scouted_edges = 0;
+
+	int start_word = (int) (((long) state->nb_bitmap_words * thread_num) / nb_threads);
+	int end_word   = (int) (((long) state->nb_bitmap_words * (thread_num + 1)) / nb_threads);
+
+	int start = start_word * 64;
+	int end   = end_word * 64 < g->nb_vertexes ? end_word * 64 : g->nb_vertexes;
+
+	for (int w = start_word; w < end_word; w++)
+		state->next_frontier_bitmap[w] = 0;
+
+	for (int v = start; v < end; v++)
 	{
-		COMPLEXITY ++;
-		int nd = popFromList(waiting);
-		COMPLEXITY += 3;
+		if (state->depths[v] != UNREACHED_DEPTH)
+			continue;
 
-		COMPLEXITY ++;
-		if ( !seen[nd])
+		for (Edge* edge = g->edges[v]; edge != NULL; edge = edge->next)
 		{
-			seen[nd] = true;
-			Edge* EL = g->edges[nd];
-			COMPLEXITY += 3;
-			while (EL != NULL)
+			int neighbour = edge->destination;
+
+			if (state->frontier_bitmap[neighbour / 64] & ((uint64_t) 1 << (neighbour % 64)))
 			{
-				addElementToList (waiting, EL->destination);
-				EL = EL->next;
-				COMPLEXITY += 5+1;
+				state->depths[v] = next_depth;
+				state->next_frontier_bitmap[v / 64] |= (uint64_t) 1 << (v % 64);
+				nb_awake_vertexes++;
+				nb_scouted_edges += g->degrees[v];
+				break;
 			}
+		}
+	}
 
+	state->nb_awake_vertexes[thread_num] = nb_awake_vertexes;
+	state->nb_scouted_edges[thread_num]  = nb_scouted_edges;
+}
+
+void convertFrontierToBitmap (BFSState* state)
+{
+	memset(state->frontier_bitmap, 0, state->nb_bitmap_words * sizeof(uint64_t));
+
+	for (int i = 0; i < state->frontier_size; i++)
+	{
+		int vertex = state->frontier[i];
+		state->frontier_bitmap[vertex / 64] |= (uint64_t) 1 << (vertex % 64);
+	}
+}
+
+void convertBitmapToFrontier (BFSState* state)
+{
+	state->frontier_size = 0;
+
+	for (int w = 0; w < state->nb_bitmap_words; w++)
+	{
+		uint64_t word = state->frontier_bitmap[w];
+
+		while (word != 0)
+		{
+			int bit = __builtin_ctzll(word);
+			state->frontier[state->frontier_size] = 64 * w + bit;
+			(state->frontier_size)++;
+
+			word &= word - 1;
 		}
 	}
+}
+
+// Returns the number of edges of a shortest path (in hops) from s to every
+// vertex (UNREACHED_DEPTH if there is none); the weights are ignored
+// A null or negative number of threads selects a default value
+int* breadthFirstSearch (Graph* g, int s, int nb_threads)
+{
+	int nb_vertexes = g->nb_vertexes;
+
+	if (nb_threads <= 0)
+		nb_threads = getNbAvailableCores();
+
+	BFSState state;
+	state.graph 		  = g;
+	state.current_depth   = 0;
+	state.nb_bitmap_words = (nb_vertexes + 63) / 64;
+
+	state.depths 				= malloc((nb_vertexes + 1) * sizeof(int));
+	state.frontier 				= malloc((nb_vertexes + 1) * sizeof(int));
+	state.frontier_bitmap 		= malloc((state.nb_bitmap_words + 1) * sizeof(uint64_t));
+	state.next_frontier_bitmap 	= malloc((state.nb_bitmap_words + 1) * sizeof(uint64_t));
+	state.next_frontiers 		= malloc(nb_threads * sizeof(Stack));
+	state.nb_awake_vertexes 	= malloc(nb_threads * sizeof(int));
+	state.nb_scouted_edges 		= malloc(nb_threads * sizeof(long));
+	CHECK_MALLOC(state.depths);
+	CHECK_MALLOC(state.frontier);
+	CHECK_MALLOC(state.frontier_bitmap);
+	CHECK_MALLOC(state.next_frontier_bitmap);
+	CHECK_MALLOC(state.next_frontiers);
+	CHECK_MALLOC(state.nb_awake_vertexes);
+	CHECK_MALLOC(state.nb_scouted_edges);
+
+	for (int t = 0; t < nb_threads; t++)
+		initStack(&state.next_frontiers[t]);
+
+	for (int i = 0; i < nb_vertexes; i++)
+		state.depths[i] = UNREACHED_DEPTH;
 
-	bool res = true;
-	COMPLEXITY ++;
+	// The edges of a frontier (nb_scouted_edges) are no longer left to check
+	// once it has been expanded, in either direction
+	long nb_edges_to_check = 2 * g->nb_edges;
 
-	for (int i=0; i<g->nb_vertexes ; i++)
+	state.depths[s] 	   = 0;
+	state.frontier[0] 	   = s;
+	state.frontier_size    = 1;
+	long nb_scouted_edges  = g->degrees[s];
+
+	while (state.frontier_size > 0)
 	{
-		res = res && (seen[i]);
-		COMPLEXITY ++;
+		if (nb_scouted_edges > nb_edges_to_check / BFS_ALPHA)
+		{
+			// Bottom-up steps, while the frontier grows or stays large
+			convertFrontierToBitmap(&state);
+
+			int nb_awake_vertexes = state.frontier_size;
+			int previous_nb_awake_vertexes;
+
+			do
+			{
+				previous_nb_awake_vertexes = nb_awake_vertexes;
+				nb_edges_to_check -= nb_scouted_edges;
+
+				runInParallel(nb_threads, runBottomUpStep, &state);
+				(state.current_depth)++;
+
+				uint64_t* bitmap 		   = state.frontier_bitmap;
+				state.frontier_bitmap 	   = state.next_frontier_bitmap;
+				state.next_frontier_bitmap = bitmap;
+
+				nb_awake_vertexes = 0;
+				nb_scouted_edges  = 0;
+				for (int t = 0; t < nb_threads; t++)
+				{
+					nb_awake_vertexes += state.nb_awake_vertexes[t];
+					nb_scouted_edges  += state.nb_scouted_edges[t];
+				}
+			}
+			while (nb_awake_vertexes >= previous_nb_awake_vertexes
+			   ||  nb_awake_vertexes > nb_vertexes / BFS_BETA);
+
+			convertBitmapToFrontier(&state);
+		}
+		else
+		{
+			// Top-down step
+			nb_edges_to_check -= nb_scouted_edges;
+
+			runInParallel(nb_threads, runTopDownStep, &state);
+			(state.current_depth)++;
+
+			// The next frontiers of the threads are gathered
+			state.frontier_size = 0;
+			nb_scouted_edges 	= 0;
+
+			for (int t = 0; t < nb_threads; t++)
+			{
+				Stack* next_frontier = &state.next_frontiers[t];
+
+				memcpy(&state.frontier[state.frontier_size], next_frontier->elements,
+					   next_frontier->size * sizeof(int));
+				state.frontier_size += next_frontier->size;
+				nb_scouted_edges 	+= state.nb_scouted_edges[t];
+			}
+		}
 	}
-	
-	return res;
+
+	// Cleaning
+	for (int t = 0; t < nb_threads; t++)
+		freeStackContent(&state.next_frontiers[t]);
+
+	free(state.next_frontiers);
+	free(state.nb_awake_vertexes);
+	free(state.nb_scouted_edges);
+	free(state.frontier_bitmap);
+	free(state.next_frontier_bitmap);
+	free(state.frontier);
+
+	return state.depths;
 }
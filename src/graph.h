@@ -5,6 +5,9 @@
 #ifndef _GRAPH_H
 #define _GRAPH_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 typedef struct Edge
 {
 	int origin;
@@ -17,14 +20,76 @@ typedef struct Graph
 {
 	Edge** edges;
 	int nb_vertexes;
+
+	// Number of (undirected) edges, and number of edges of each vertex
+	long nb_edges;
+	int* degrees;
+
+	// Every edge weight lies between these bounds (INT_MAX and INT_MIN if there
+	// is no edge); they are not tightened when a weight is modified
+	int min_weight;
+	int max_weight;
+
+	// Number of connected components (UNKNOWN_NB_COMPONENTS if it has not
+	// been computed since the last edge insertion)
+	int nb_components;
 } Graph;
 
+#define UNKNOWN_NB_COMPONENTS -1
+
+// Edges read from a graph file, before the adjacency lists are built
+typedef struct GraphEdgeArray
+{
+	int nb_vertexes;
+	int nb_edges;
+	int* origins;
+	int* destinations;
+	int* weights;
+	int nb_components;
+} GraphEdgeArray;
+
+// Header of a binary graph file (compressed sparse rows), followed by:
+// - the offsets of the adjacency of every vertex (nb_vertexes + 1 int64)
+// - the destinations and the weights of the 2 * nb_edges edge ends (int32)
+// Every edge appears in the adjacency of both of its ends (a loop appears twice
+// in a row in the adjacency of its vertex)
+#define GRAPH_FILE_MAGIC "CSRG"
+typedef struct GraphFileHeader
+{
+	char magic[4];
+	int32_t nb_vertexes;
+	int64_t nb_edges;
+} GraphFileHeader;
+
+// Depth of a vertex which has not been reached by a breadth-first search
+#define UNREACHED_DEPTH -1
+
+// State shared by the threads of a breadth-first search (defined in graph.c)
+typedef struct BFSState BFSState;
+
 //------------------------------------------------------------------------------
 
 Edge* createEdge (int origin, int destination, int weight, Edge* next);
 Graph* createEmptyGraph (int nb_vertexes);
+void freeGraph (Graph* graph);
+void updateWeightBounds (Graph* graph, int weight);
 void addUndirectedEdgeToGraph (Graph* graph, int source, int destination, int weight);
+bool setUndirectedEdgeWeight (Graph* graph, int origin, int destination, int weight);
+bool getEdgeWeight (Graph* graph, int origin, int destination, int* weight);
+GraphEdgeArray* createGraphEdgeArray (int nb_vertexes, int nb_edges);
+GraphEdgeArray* readGraphEdgesFromTextFile (FILE* file);
+GraphEdgeArray* readGraphEdgesFromBinaryFile (FILE* file);
+GraphEdgeArray* readGraphEdgesFromFile (FILE* file);
+void freeGraphEdgeArray (GraphEdgeArray* edge_array);
+Graph* createGraphFromEdgeArray (GraphEdgeArray* edge_array);
 Graph* createGraphFromFile (FILE* file);
+Graph* createConnectedGraphFromFile (FILE* file, int* nb_components);
 bool graphIsConnected (Graph* graph);
 
+void runTopDownStep (int thread_num, int nb_threads, void* state);
+void runBottomUpStep (int thread_num, int nb_threads, void* state);
+void convertFrontierToBitmap (BFSState* state);
+void convertBitmapToFrontier (BFSState* state);
+int* breadthFirstSearch (Graph* g, int s, int nb_threads);
+
 #endif
@@ -2,184 +2,1445 @@
 // RANDOM GRAPH GENERATOR
 //------------------------------------------------------------------------------
 // Implementation of a simple random undirected, weighted graph generator,
-// parameterized by the number of vertices and the density of the graph.
-// The graph is printed on the standard output.
+// parameterized by the number of vertices and the density of the graph, with
+// several models: uniform (Erdos-Renyi), 2D grid, R-MAT, Barabasi-Albert and
+// random geometric graphs (see graph_gen.h).
+// The graph is printed on the standard output, in the text format or in the
+// binary format of graph.h (the text is formatted by hand in large buffers,
+// written with a few write() calls). A whole corpus of numbered graphs can
+// also be generated at once, in parallel, with a manifest of their seeds and
+// checksums.
+//
+// In the uniform model, the m edges are a uniform sample (without
+// replacement) of the N = n(n+1)/2 pairs of vertices, drawn in increasing
+// order with Vitter's sequential sampling (method D, and method A for the last
+// samples or dense graphs): the gap to the next sampled pair is drawn
+// directly, so the generation takes O(m) time, and no matrix of the pairs is
+// ever built. The grid model samples its edges in the same way.
+//
+// The generation is parallel and reproducible: the items of the model (pairs,
+// grid edges, edge draws or vertices) are split into chunks whose layout only
+// depends on the parameters; when the number of edges is fixed, the number of
+// edges of each chunk is drawn from a hypergeometric distribution. The chunks
+// are then generated independently by the threads, each one with its own
+// random stream derived from the seed. The same seed thus gives the same
+// graph, whatever the number of threads.
 //------------------------------------------------------------------------------
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <math.h>
+#include <limits.h>
 #include <assert.h>
 #include <stdbool.h>
-#include "graph_gen.h"
+#include <stdint.h>
+#include <inttypes.h>
 #include "toolbox.h"
+#include "prng.h"
+#include "parallel.h"
+#include "graph.h"
+#include "connectivity.h"
+#include "graph_gen.h"
+
+//------------------------------------------------------------------------------
+// RANDOM NUMBERS
+//------------------------------------------------------------------------------
+
+// log(x!), from Stirling's series for large values
+double computeLogFactorial (int64_t x)
+{
+	if (x < 16)
+		return lgamma((double) x + 1.0);
+
+	double y = (double) x;
+	return (y + 0.5) * log(y) - y + 0.5 * log(2.0 * M_PI)
+		 + 1.0 / (12.0 * y) - 1.0 / (360.0 * y * y * y);
+}
+
+// log(a! / b!) for a >= b, without the cancellation of the difference of two
+// large logarithms
+double computeLogFactorialRatio (int64_t a, int64_t b)
+{
+	if (a == b)
+		return 0.0;
+	if (b < 16)
+		return computeLogFactorial(a) - computeLogFactorial(b);
+
+	double x = (double) a;
+	double y = (double) b;
+	double d = (double) (a - b);
+
+	return (y + 0.5) * log1p(d / y) + d * (log(x) - 1.0)
+		 + (1.0 / (12.0 * x) - 1.0 / (12.0 * y))
+		 - (1.0 / (360.0 * x * x * x) - 1.0 / (360.0 * y * y * y));
+}
+
+// Standard normal distribution (Box-Muller transform)
+double getRandomNormalDouble (Prng* prng)
+{
+	double u = getRandomOpenUnitDouble(prng);
+	double v = getRandomUnitDouble(prng);
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+// Number of successes among nb_draws draws without replacement, in a
+// population containing nb_successes successes
+// Small expectations are drawn exactly (by inversion, starting from the
+// smallest possible value, whose probability is a product of factorial ratios
+// spanning at most nb_draws factors each); larger ones from the normal
+// approximation, whose error is negligible for the sizes of the chunks
+int64_t drawHypergeometric (Prng* prng, int64_t nb_draws, int64_t nb_successes,
+							int64_t population)
+{
+	int64_t nb_failures = population - nb_successes;
+	int64_t min_value 	= nb_draws > nb_failures ? nb_draws - nb_failures : 0;
+	int64_t max_value 	= nb_draws < nb_successes ? nb_draws : nb_successes;
+
+	if (min_value == max_value)
+		return min_value;
+
+	double ratio 	= (double) nb_successes / (double) population;
+	double mean 	= (double) nb_draws * ratio;
+	double variance = mean * (1.0 - ratio) * (double) (population - nb_draws)
+					/ (double) (population - 1);
+
+	if (mean - (double) min_value < HYPERGEOMETRIC_INVERSION_THRESHOLD)
+	{
+		int64_t k = min_value;
+		double probability = exp(computeLogFactorialRatio(nb_successes, nb_successes - k)
+							   - computeLogFactorial(k)
+							   + computeLogFactorialRatio(nb_failures, nb_failures - nb_draws + k)
+							   - computeLogFactorialRatio(population, population - nb_draws)
+							   + computeLogFactorialRatio(nb_draws, nb_draws - k));
+		double u = getRandomUnitDouble(prng);
 
+		while (u > probability && k < max_value)
+		{
+			u -= probability;
+			probability *= ((double) (nb_successes - k) * (double) (nb_draws - k))
+						 / ((double) (k + 1) * (double) (nb_failures - nb_draws + k + 1));
+			k++;
+		}
+
+		return k;
+	}
+
+	double value = round(mean + sqrt(variance) * getRandomNormalDouble(prng));
+
+	if (value < (double) min_value)
+		return min_value;
+	if (value > (double) max_value)
+		return max_value;
+
+	return (int64_t) value;
+}
+
+//------------------------------------------------------------------------------
+// PAIRS OF VERTICES
 //------------------------------------------------------------------------------
 
-void swapValues (int* x, int* y)
+int64_t computeNbPairs (int nb_vertices)
 {
-	int temp = *x;
-	*x = *y;
-	*y = temp;
+	return ((int64_t) nb_vertices * (nb_vertices + 1)) / 2;
 }
 
-int getRandomBoundedInt (int min, int max)
+int64_t computeNbEdges (int64_t nb_items, double density)
 {
-	return rand() % (max - min + 1) + min;
+	return (int64_t) (0.5 + (double) nb_items * density);
 }
 
-int computeNbEdges (int nb_vertices, double density)
+// Place the cursor on the row of a given pair (the square root is only an
+// estimation, corrected in both directions)
+void initPairCursor (PairCursor* cursor, int64_t pair_index)
 {
-	return (int) 0.5 + (((nb_vertices * (nb_vertices + 1)) / 2) * density);
+	int64_t origin = (int64_t) ((sqrt(8.0 * (double) pair_index + 1.0) - 1.0) / 2.0);
+
+	while (origin > 0 && (origin * (origin + 1)) / 2 > pair_index)
+		origin--;
+	while (((origin + 1) * (origin + 2)) / 2 <= pair_index)
+		origin++;
+
+	cursor->origin 	  = (int) origin;
+	cursor->row_start = (origin * (origin + 1)) / 2;
 }
 
-// If remove_edge is true, the edge is not added, but actually removed
-// This is used in the case of the generation of highly dense graphs
-void generateNewRandomEdge (int** edges, int nb_vertices, int no_edge_weight,
-							int min_weight, int max_weight, bool remove_edge)
+// The pair indexes must be given in increasing order: moving the cursor costs
+// O(number of skipped rows), i.e. O(n) for the whole generation
+void movePairCursor (PairCursor* cursor, int64_t pair_index)
 {
-	// The origin and destination are picked at random, until an unseen
-	// combination is found
-	int origin, destination, weight;
+	while (pair_index >= cursor->row_start + cursor->origin + 1)
+	{
+		cursor->row_start += cursor->origin + 1;
+		(cursor->origin)++;
+	}
+}
+
+//------------------------------------------------------------------------------
+// OUTPUT
+//------------------------------------------------------------------------------
+
+// Decimal representation of an integer, written from the given position
+// Returns the position following the last digit
+char* formatInteger (char* position, int64_t value)
+{
+	char digits[20];
+	int nb_digits = 0;
+	uint64_t magnitude = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+
+	if (value < 0)
+		*(position++) = '-';
 
 	do
 	{
-		origin 		= getRandomBoundedInt(0, nb_vertices - 1);
-		destination = getRandomBoundedInt(0, nb_vertices - 1);
+		digits[nb_digits++] = (char) ('0' + magnitude % 10);
+		magnitude /= 10;
+	}
+	while (magnitude > 0);
+
+	while (nb_digits > 0)
+		*(position++) = digits[--nb_digits];
+
+	return position;
+}
+
+// Make room for size more bytes at the end of the buffer
+// Returns the position of these bytes (the size is not updated)
+char* reserveOutputBuffer (OutputBuffer* buffer, size_t size)
+{
+	if (buffer->size + size > buffer->capacity)
+	{
+		buffer->capacity = 2 * (buffer->size + size);
+		buffer->bytes 	 = realloc(buffer->bytes, buffer->capacity);
+		CHECK_MALLOC(buffer->bytes);
+	}
+
+	return buffer->bytes + buffer->size;
+}
+
+// The bytes are written directly on the file descriptor of the output, in a
+// few large calls (anything buffered in the FILE structure is flushed first),
+// and added to the checksum of the output
+void writeToFile (GenerationState* state, void* bytes, size_t size)
+{
+	fflush(state->output);
+	int file_descriptor = fileno(state->output);
+	char* position = bytes;
+
+	state->checksum = hashBytes(state->checksum, bytes, size);
+
+	while (size > 0)
+	{
+		ssize_t nb_written = write(file_descriptor, position, size);
+		if (nb_written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			fprintf(stderr, "Error: the graph cannot be written.\n");
+			exit(1);
+		}
+
+		position += nb_written;
+		size 	 -= (size_t) nb_written;
+	}
+}
+
+void writeEdge (EdgeWriter* writer, int origin, int destination, int weight)
+{
+	(writer->nb_edges)++;
+
+	if (writer->state->format == BINARY_GRAPH_FORMAT)
+	{
+		int32_t triple[3] = { origin, destination, weight };
+		memcpy(reserveOutputBuffer(&writer->buffer, sizeof(triple)), triple, sizeof(triple));
+		writer->buffer.size += sizeof(triple);
+		return;
+	}
+
+	// At most 3 * 11 characters and 3 separators
+	char* start = reserveOutputBuffer(&writer->buffer, 36);
+	char* end 	= formatInteger(start, origin);
+	*(end++) 	= ' ';
+	end 		= formatInteger(end, destination);
+	*(end++) 	= ' ';
+	end 		= formatInteger(end, weight);
+	*(end++) 	= '\n';
+
+	writer->buffer.size += (size_t) (end - start);
+}
 
-		if (destination > origin)
-			swapValues(&origin, &destination);
+// Edge sampled by the uniform or the grid model (or edge of a spanning tree)
+// The index is relative to the first item of the writer's chunk, and skips
+// the excluded items (the indexes must be given in increasing order)
+void writeSampledEdge (EdgeWriter* writer, int64_t index)
+{
+	GenerationState* state = writer->state;
+	int origin, destination;
+
+	index += writer->first_item + writer->nb_skipped_items;
+
+	while (writer->next_excluded_item < writer->end_excluded_item
+	&&     state->tree_items[writer->next_excluded_item] <= index)
+	{
+		index++;
+		(writer->nb_skipped_items)++;
+		(writer->next_excluded_item)++;
 	}
-	while ((   remove_edge  && edges[origin][destination] == no_edge_weight)
-	   ||  ((! remove_edge) && edges[origin][destination] != no_edge_weight));
 
-	// Add or remove the edge, depending on the flag value
-	if (remove_edge)
-		edges[origin][destination] = no_edge_weight;
+	if (state->model == GRID_MODEL)
+		getGridEdge(state->nb_vertices, state->grid_width, index, &origin, &destination);
 	else
 	{
-		weight = getRandomBoundedInt(min_weight, max_weight);
-		edges[origin][destination] = weight;
+		movePairCursor(&writer->cursor, index);
+		origin 		= writer->cursor.origin;
+		destination = (int) (index - writer->cursor.row_start);
 	}
+
+	int weight = getRandomIntInRange(&writer->prng, state->min_weight, state->max_weight);
+	writeEdge(writer, origin, destination, weight);
 }
 
-// This function may consume a lot of memory!
-int** generateRandomGraph (int nb_vertices, double density, int no_edge_weight,
-						   int min_weight, int max_weight)
+// The binary format lists the edges by vertex: it can only be written once all
+// the chunks have been generated (the edges of a vertex are written in their
+// order of generation, then a loop is written twice in a row)
+void writeBinaryGraph (GenerationState* state, int64_t nb_edges)
 {
-	// The density gives the number of edges...
-	int nb_edges = computeNbEdges(nb_vertices, density);
+	int nb_vertices 		= state->nb_vertices;
+	GenerationChunk* chunks = state->chunks;
+	int64_t nb_chunks 		= state->nb_chunks;
+	size_t nb_edge_ends 	= 2 * (size_t) nb_edges;
 
-	// ...and the generation mode: in order to be (way) more performant, if the graph is dense,
-	// i.e. density > 0.5, the graph is initialized with all the edges (with random weights),
-	// and edges are removed from it until the right number of edges is reached
-	bool remove_edges = density > 0.5;
+	int64_t* offsets 	  = calloc((size_t) nb_vertices + 1, sizeof(int64_t));
+	int64_t* positions 	  = malloc(((size_t) nb_vertices + 1) * sizeof(int64_t));
+	int32_t* destinations = malloc((nb_edge_ends + 1) * sizeof(int32_t));
+	int32_t* weights 	  = malloc((nb_edge_ends + 1) * sizeof(int32_t));
+	CHECK_MALLOC(offsets);
+	CHECK_MALLOC(positions);
+	CHECK_MALLOC(destinations);
+	CHECK_MALLOC(weights);
 
-	// Edges matrix allocation and initialization
-	// This assumes that the following always holds true: (origin >= destination)
-	int** edges = malloc(nb_vertices * sizeof(int*));
-	CHECK_MALLOC(edges);
+	// Degrees, then offsets of the adjacencies
+	for (int64_t c = 0; c < nb_chunks; c++)
+	{
+		int32_t* triples = (int32_t*) chunks[c].buffer.bytes;
+		for (int64_t i = 0; i < chunks[c].nb_edges; i++)
+		{
+			offsets[triples[3 * i] + 1]++;
+			offsets[triples[3 * i + 1] + 1]++;
+		}
+	}
 
-	if (remove_edges)
+	for (int v = 0; v < nb_vertices; v++)
 	{
-		for (int i = 0; i < nb_vertices; i++)
+		offsets[v + 1] += offsets[v];
+		positions[v] 	= offsets[v];
+	}
+
+	// Both ends of every edge
+	for (int64_t c = 0; c < nb_chunks; c++)
+	{
+		int32_t* triples = (int32_t*) chunks[c].buffer.bytes;
+		for (int64_t i = 0; i < chunks[c].nb_edges; i++)
+		{
+			int32_t origin 		= triples[3 * i];
+			int32_t destination = triples[3 * i + 1];
+			int32_t weight 		= triples[3 * i + 2];
+
+			destinations[positions[origin]] = destination;
+			weights[positions[origin]++] 	= weight;
+			destinations[positions[destination]] = origin;
+			weights[positions[destination]++] 	 = weight;
+		}
+	}
+
+	GraphFileHeader header;
+	memcpy(header.magic, GRAPH_FILE_MAGIC, 4);
+	header.nb_vertexes = nb_vertices;
+	header.nb_edges    = nb_edges;
+
+	writeToFile(state, &header, sizeof(header));
+	writeToFile(state, offsets, ((size_t) nb_vertices + 1) * sizeof(int64_t));
+	writeToFile(state, destinations, nb_edge_ends * sizeof(int32_t));
+	writeToFile(state, weights, nb_edge_ends * sizeof(int32_t));
+
+	free(offsets);
+	free(positions);
+	free(destinations);
+	free(weights);
+}
+
+//------------------------------------------------------------------------------
+// SEQUENTIAL SAMPLING (VITTER)
+//------------------------------------------------------------------------------
+
+// Method A: the number of skipped pairs is found by inversion, in O(skip)
+// current_index is the index of the last sampled pair (-1 if there is none)
+void sampleWithMethodA (EdgeWriter* writer, int64_t nb_samples, int64_t nb_pairs,
+						int64_t current_index)
+{
+	if (nb_samples <= 0)
+		return;
+
+	double top 	   = (double) (nb_pairs - nb_samples);
+	double nb_left = (double) nb_pairs;
+
+	while (nb_samples >= 2)
+	{
+		double v = getRandomOpenUnitDouble(&writer->prng);
+		int64_t skip = 0;
+		double quotient = top / nb_left;
+
+		while (quotient > v)
+		{
+			skip++;
+			top--;
+			nb_left--;
+			quotient = (quotient * top) / nb_left;
+		}
+
+		current_index += skip + 1;
+		writeSampledEdge(writer, current_index);
+
+		nb_left--;
+		nb_samples--;
+	}
+
+	// Last sample: uniform among the remaining pairs
+	int64_t skip = (int64_t) (round(nb_left) * getRandomOpenUnitDouble(&writer->prng));
+	current_index += skip + 1;
+	writeSampledEdge(writer, current_index);
+}
+
+// Method D: the skip is drawn by rejection from a continuous approximation,
+// in O(1) expected time; method A takes over when few pairs remain
+// (J. S. Vitter, "An efficient algorithm for sequential random sampling", 1987)
+void sampleWithMethodD (EdgeWriter* writer, int64_t nb_samples, int64_t nb_pairs)
+{
+	int64_t current_index = -1;
+
+	if (nb_samples <= 0)
+		return;
+
+	double nb_samples_inverse = 1.0 / (double) nb_samples;
+	double v_prime = exp(log(getRandomOpenUnitDouble(&writer->prng)) * nb_samples_inverse);
+
+	int64_t quotient_1 = nb_pairs - nb_samples + 1;
+	int64_t threshold  = METHOD_D_THRESHOLD_RATIO * nb_samples;
+
+	while (nb_samples > 1 && threshold < nb_pairs)
+	{
+		double nb_samples_minus_1_inverse = 1.0 / (double) (nb_samples - 1);
+		int64_t skip;
+
+		while (true)
+		{
+			// Candidate skip, from the continuous approximation
+			double x;
+			while (true)
+			{
+				x 	 = (double) nb_pairs * (1.0 - v_prime);
+				skip = (int64_t) x;
+				if (skip < quotient_1)
+					break;
+				v_prime = exp(log(getRandomOpenUnitDouble(&writer->prng)) * nb_samples_inverse);
+			}
+
+			// Fast acceptance test
+			double u  = getRandomOpenUnitDouble(&writer->prng);
+			double y1 = exp(log(u * (double) nb_pairs / (double) quotient_1)
+							* nb_samples_minus_1_inverse);
+			v_prime = y1 * (1.0 - x / (double) nb_pairs)
+					* ((double) quotient_1 / (double) (quotient_1 - skip));
+
+			if (v_prime <= 1.0)
+				break;
+
+			// Exact acceptance test
+			double y2 	 = 1.0;
+			double top 	 = (double) (nb_pairs - 1);
+			double bottom;
+			int64_t limit;
+
+			if (nb_samples - 1 > skip)
+			{
+				bottom = (double) (nb_pairs - nb_samples);
+				limit  = nb_pairs - skip;
+			}
+			else
+			{
+				bottom = (double) (nb_pairs - skip - 1);
+				limit  = quotient_1;
+			}
+
+			for (int64_t t = nb_pairs - 1; t >= limit; t--)
+			{
+				y2 = (y2 * top) / bottom;
+				top--;
+				bottom--;
+			}
+
+			if ((double) nb_pairs / ((double) nb_pairs - x)
+				>= y1 * exp(log(y2) * nb_samples_minus_1_inverse))
+			{
+				v_prime = exp(log(getRandomOpenUnitDouble(&writer->prng)) * nb_samples_minus_1_inverse);
+				break;
+			}
+
+			v_prime = exp(log(getRandomOpenUnitDouble(&writer->prng)) * nb_samples_inverse);
+		}
+
+		current_index += skip + 1;
+		writeSampledEdge(writer, current_index);
+
+		nb_pairs 		  -= skip + 1;
+		nb_samples--;
+		nb_samples_inverse = nb_samples_minus_1_inverse;
+		quotient_1 		  -= skip;
+		threshold 		  -= METHOD_D_THRESHOLD_RATIO;
+	}
+
+	if (nb_samples > 1)
+		sampleWithMethodA(writer, nb_samples, nb_pairs, current_index);
+	else
+	{
+		int64_t skip = (int64_t) ((double) nb_pairs * v_prime);
+		current_index += skip + 1;
+		writeSampledEdge(writer, current_index);
+	}
+}
+
+//------------------------------------------------------------------------------
+// MODELS
+//------------------------------------------------------------------------------
+
+// The vertices of the grid are numbered row by row (the last row may be
+// incomplete); the horizontal edges come first, then the vertical ones
+int64_t computeNbGridEdges (int nb_vertices, int width)
+{
+	int64_t nb_rows = ((int64_t) nb_vertices + width - 1) / width;
+	int64_t nb_vertical_edges = nb_vertices > width ? nb_vertices - width : 0;
+
+	return (nb_vertices - nb_rows) + nb_vertical_edges;
+}
+
+void getGridEdge (int nb_vertices, int width, int64_t index, int* origin, int* destination)
+{
+	int64_t nb_rows = ((int64_t) nb_vertices + width - 1) / width;
+	int64_t nb_horizontal_edges = nb_vertices - nb_rows;
+
+	if (index < nb_horizontal_edges)
+	{
+		int64_t row = index / (width - 1);
+		int64_t column = index % (width - 1);
+
+		*destination = (int) (row * width + column);
+		*origin 	 = *destination + 1;
+	}
+	else
+	{
+		*destination = (int) (index - nb_horizontal_edges);
+		*origin 	 = *destination + width;
+	}
+}
+
+// Each edge is drawn independently: at every level, a quadrant of the
+// adjacency matrix is chosen (cells outside the n x n matrix are redrawn)
+// (D. Chakrabarti, Y. Zhan, C. Faloutsos, "R-MAT: a recursive model for
+// graph mining", 2004)
+void generateRMATEdges (EdgeWriter* writer, int64_t nb_edges)
+{
+	GenerationState* state = writer->state;
+	double* probabilities = state->rmat_probabilities;
+	double threshold_b = probabilities[0] + probabilities[1];
+	double threshold_c = threshold_b + probabilities[2];
+
+	for (int64_t e = 0; e < nb_edges; e++)
+	{
+		int64_t row, column;
+
+		do
 		{
-			edges[i] = malloc((i + 1) * sizeof(int));
-			CHECK_MALLOC(edges[i]);
+			row 	= 0;
+			column 	= 0;
 
-			for (int j = 0; j < (i + 1); j++)
-				edges[i][j] = getRandomBoundedInt(min_weight, max_weight);
+			for (int level = 0; level < state->rmat_scale; level++)
+			{
+				double u = getRandomUnitDouble(&writer->prng);
+				row    = 2 * row + (u >= threshold_b);
+				column = 2 * column + ((u >= probabilities[0] && u < threshold_b) || u >= threshold_c);
+			}
 		}
+		while (row >= state->nb_vertices || column >= state->nb_vertices);
+
+		int weight = getRandomIntInRange(&writer->prng, state->min_weight, state->max_weight);
+
+		if (row >= column)
+			writeEdge(writer, (int) row, (int) column, weight);
+		else
+			writeEdge(writer, (int) column, (int) row, weight);
+	}
+}
+
+// Preferential attachment: every edge end is recorded in a list, and picking a
+// uniform element of this list picks a vertex with a probability proportional
+// to its degree; the first end of a vertex is recorded before its edges are
+// drawn, so loops (and parallel edges) may appear
+// (V. Batagelj, U. Brandes, "Efficient generation of large random networks",
+// 2005). This model is sequential: it is generated as a single chunk.
+void generateBarabasiAlbertEdges (EdgeWriter* writer)
+{
+	GenerationState* state = writer->state;
+	int nb_attachments = state->nb_attachments;
+	int64_t nb_edge_ends = 2 * (int64_t) state->nb_vertices * nb_attachments;
+
+	int* edge_ends = malloc((nb_edge_ends + 1) * sizeof(int));
+	CHECK_MALLOC(edge_ends);
+
+	for (int v = 0; v < state->nb_vertices; v++)
+		for (int i = 0; i < nb_attachments; i++)
+		{
+			int64_t end = 2 * ((int64_t) v * nb_attachments + i);
+
+			edge_ends[end] 	   = v;
+			edge_ends[end + 1] = edge_ends[getRandomBoundedUint64(&writer->prng, end + 1)];
+
+			int weight = getRandomIntInRange(&writer->prng, state->min_weight, state->max_weight);
+			writeEdge(writer, v, edge_ends[end + 1], weight);
+		}
+
+	free(edge_ends);
+}
+
+// Place the vertices uniformly in the unit square, then sort them by cell
+// (counting sort); the cells are at least as wide as the radius, so the
+// neighbours of a vertex lie in its cell or in the 8 surrounding ones
+void placeVerticesInCells (GenerationState* state)
+{
+	int nb_vertices = state->nb_vertices;
+	double nb_cells_per_side = state->radius > 0.0 ? floor(1.0 / state->radius) : 1.0;
+	double max_nb_cells_per_side = floor(sqrt((double) nb_vertices));
+
+	if (nb_cells_per_side > max_nb_cells_per_side)
+		nb_cells_per_side = max_nb_cells_per_side;
+	if (nb_cells_per_side < 1.0)
+		nb_cells_per_side = 1.0;
+
+	state->nb_cells_per_side = (int) nb_cells_per_side;
+
+	int nb_cells = state->nb_cells_per_side * state->nb_cells_per_side;
+	int* cells 	 = malloc(((size_t) nb_vertices + 1) * sizeof(int));
+	state->coordinates 	 = malloc((2 * (size_t) nb_vertices + 1) * sizeof(double));
+	state->cell_offsets  = calloc((size_t) nb_cells + 1, sizeof(int));
+	state->cell_vertices = malloc(((size_t) nb_vertices + 1) * sizeof(int));
+	CHECK_MALLOC(cells);
+	CHECK_MALLOC(state->coordinates);
+	CHECK_MALLOC(state->cell_offsets);
+	CHECK_MALLOC(state->cell_vertices);
+
+	Prng prng;
+	seedPrng(&prng, state->seed, VERTEX_POSITIONS_STREAM);
+
+	for (int v = 0; v < nb_vertices; v++)
+	{
+		double x = getRandomUnitDouble(&prng);
+		double y = getRandomUnitDouble(&prng);
+
+		state->coordinates[2 * v] 	  = x;
+		state->coordinates[2 * v + 1] = y;
+
+		int cell_x = (int) (x * state->nb_cells_per_side);
+		int cell_y = (int) (y * state->nb_cells_per_side);
+		cells[v] = cell_y * state->nb_cells_per_side + cell_x;
+
+		state->cell_offsets[cells[v] + 1]++;
+	}
+
+	for (int c = 0; c < nb_cells; c++)
+		state->cell_offsets[c + 1] += state->cell_offsets[c];
+
+	// Vertices of a cell are kept in increasing order
+	int* positions = malloc(((size_t) nb_cells + 1) * sizeof(int));
+	CHECK_MALLOC(positions);
+	memcpy(positions, state->cell_offsets, (size_t) nb_cells * sizeof(int));
+
+	for (int v = 0; v < nb_vertices; v++)
+		state->cell_vertices[positions[cells[v]]++] = v;
+
+	free(positions);
+	free(cells);
+}
+
+// Edges between the given vertices and the vertices of smaller number
+void generateGeometricEdges (EdgeWriter* writer, int64_t first_vertex, int64_t nb_vertices)
+{
+	GenerationState* state = writer->state;
+	int nb_cells_per_side  = state->nb_cells_per_side;
+	double* coordinates    = state->coordinates;
+	double squared_radius  = state->radius * state->radius;
+	double weight_range    = (double) state->max_weight - (double) state->min_weight;
+
+	for (int v = (int) first_vertex; v < first_vertex + nb_vertices; v++)
+	{
+		double x = coordinates[2 * v];
+		double y = coordinates[2 * v + 1];
+		int cell_x = (int) (x * nb_cells_per_side);
+		int cell_y = (int) (y * nb_cells_per_side);
+
+		for (int neighbour_y = cell_y - 1; neighbour_y <= cell_y + 1; neighbour_y++)
+			for (int neighbour_x = cell_x - 1; neighbour_x <= cell_x + 1; neighbour_x++)
+			{
+				if (neighbour_x < 0 || neighbour_x >= nb_cells_per_side
+				||  neighbour_y < 0 || neighbour_y >= nb_cells_per_side)
+					continue;
+
+				int cell = neighbour_y * nb_cells_per_side + neighbour_x;
+
+				for (int i = state->cell_offsets[cell]; i < state->cell_offsets[cell + 1]; i++)
+				{
+					int u = state->cell_vertices[i];
+					if (u >= v)
+						break;
+
+					double dx = coordinates[2 * u] - x;
+					double dy = coordinates[2 * u + 1] - y;
+					double squared_distance = dx * dx + dy * dy;
+
+					if (squared_distance > squared_radius)
+						continue;
+
+					double ratio = sqrt(squared_distance) / state->radius;
+					int weight 	 = state->min_weight + (int) round(weight_range * ratio);
+					writeEdge(writer, v, u, weight);
+				}
+			}
 	}
+}
+
+//------------------------------------------------------------------------------
+// SPANNING TREE
+//------------------------------------------------------------------------------
 
+int compareItems (const void* item_1, const void* item_2)
+{
+	int64_t value_1 = *((const int64_t*) item_1);
+	int64_t value_2 = *((const int64_t*) item_2);
+
+	return (value_1 > value_2) - (value_1 < value_2);
+}
+
+// Random spanning tree of a connected graph, whose edges are then excluded from
+// the sampled items (and written in a chunk of their own):
+// - for the grid model, a random spanning tree of the grid (Kruskal's
+//   algorithm on the grid edges in a random order), so edges stay local
+// - otherwise, a random recursive tree: the vertices are visited in a random
+//   order, and each one is attached to a uniform earlier vertex
+void buildRandomSpanningTree (GenerationState* state)
+{
+	int nb_vertices = state->nb_vertices;
+
+	state->tree_items 	 = malloc((size_t) nb_vertices * sizeof(int64_t));
+	state->nb_tree_items = 0;
+	CHECK_MALLOC(state->tree_items);
+
+	Prng prng;
+	seedPrng(&prng, state->seed, SPANNING_TREE_STREAM);
+
+	if (state->model == GRID_MODEL)
+	{
+		int64_t nb_grid_edges = computeNbGridEdges(nb_vertices, state->grid_width);
+		int64_t* grid_edges   = malloc((nb_grid_edges + 1) * sizeof(int64_t));
+		CHECK_MALLOC(grid_edges);
+
+		// Fisher-Yates shuffle ("inside-out" version)
+		for (int64_t i = 0; i < nb_grid_edges; i++)
+		{
+			int64_t j = (int64_t) getRandomBoundedUint64(&prng, (uint64_t) i + 1);
+			grid_edges[i] = i == j ? i : grid_edges[j];
+			grid_edges[j] = i;
+		}
+
+		UnionFind* union_find = createUnionFind(nb_vertices);
+		int origin, destination;
+
+		for (int64_t i = 0; i < nb_grid_edges && state->nb_tree_items < nb_vertices - 1; i++)
+		{
+			getGridEdge(nb_vertices, state->grid_width, grid_edges[i], &origin, &destination);
+			if (mergeSets(union_find, origin, destination))
+				state->tree_items[(state->nb_tree_items)++] = grid_edges[i];
+		}
+
+		freeUnionFind(union_find);
+		free(grid_edges);
+	}
 	else
 	{
+		int* order = malloc(((size_t) nb_vertices + 1) * sizeof(int));
+		CHECK_MALLOC(order);
+
 		for (int i = 0; i < nb_vertices; i++)
 		{
-			edges[i] = malloc((i + 1) * sizeof(int));
-			CHECK_MALLOC(edges[i]);
+			int j = (int) getRandomBoundedUint64(&prng, (uint64_t) i + 1);
+			order[i] = i == j ? i : order[j];
+			order[j] = i;
+		}
+
+		for (int i = 1; i < nb_vertices; i++)
+		{
+			int parent = order[getRandomBoundedUint64(&prng, (uint64_t) i)];
+			int64_t origin 		= order[i] > parent ? order[i] : parent;
+			int64_t destination = order[i] > parent ? parent : order[i];
+
+			state->tree_items[(state->nb_tree_items)++] = (origin * (origin + 1)) / 2 + destination;
+		}
+
+		free(order);
+	}
+
+	qsort(state->tree_items, state->nb_tree_items, sizeof(int64_t), compareItems);
+}
+
+// The spanning tree is written by the first chunk
+void addSpanningTreeChunk (GenerationState* state)
+{
+	state->chunks = realloc(state->chunks, (state->nb_chunks + 1) * sizeof(GenerationChunk));
+	CHECK_MALLOC(state->chunks);
+
+	memmove(&state->chunks[1], &state->chunks[0], state->nb_chunks * sizeof(GenerationChunk));
+	(state->nb_chunks)++;
+
+	GenerationChunk* chunk = &state->chunks[0];
+	memset(chunk, 0, sizeof(GenerationChunk));
+	chunk->nb_items 	 = state->nb_tree_items;
+	chunk->nb_edges 	 = state->nb_tree_items;
+	chunk->spanning_tree = true;
+}
+
+//------------------------------------------------------------------------------
+// PARALLEL GENERATION
+//------------------------------------------------------------------------------
+
+// Split the item space into chunks of the same size, and draw the number of
+// edges of each of them: each chunk receives a hypergeometric share of the
+// edges which remain, given the items which remain (the excluded items, sorted,
+// can not be drawn)
+GenerationChunk* splitItemsIntoChunks (uint64_t seed, int64_t nb_items, int64_t nb_edges,
+									   int64_t* excluded_items, int64_t nb_excluded_items,
+									   int64_t* nb_chunks)
+{
+	int64_t nb_wanted_chunks = (nb_edges + NB_EDGES_PER_CHUNK - 1) / NB_EDGES_PER_CHUNK;
+	if (nb_wanted_chunks > nb_items)
+		nb_wanted_chunks = nb_items;
+	if (nb_wanted_chunks < 1)
+		nb_wanted_chunks = 1;
+
+	int64_t chunk_size = (nb_items + nb_wanted_chunks - 1) / nb_wanted_chunks;
+	GenerationChunk* chunks = createRegularChunks(nb_items, chunk_size, nb_chunks);
+
+	Prng prng;
+	seedPrng(&prng, seed, CHUNK_SIZES_STREAM);
+
+	int64_t nb_remaining_items = nb_items - nb_excluded_items;
+	int64_t nb_remaining_edges = nb_edges;
+	int64_t excluded_item 	   = 0;
+
+	for (int64_t c = 0; c < *nb_chunks; c++)
+	{
+		GenerationChunk* chunk = &chunks[c];
+
+		chunk->first_excluded_item = excluded_item;
+		while (excluded_item < nb_excluded_items
+		&&     excluded_items[excluded_item] < chunk->first_item + chunk->nb_items)
+			excluded_item++;
+		chunk->nb_excluded_items = excluded_item - chunk->first_excluded_item;
+
+		int64_t nb_chunk_items = chunk->nb_items - chunk->nb_excluded_items;
+		chunk->nb_edges = drawHypergeometric(&prng, nb_remaining_edges, nb_chunk_items,
+											 nb_remaining_items);
+
+		nb_remaining_items -= nb_chunk_items;
+		nb_remaining_edges -= chunk->nb_edges;
+	}
+
+	return chunks;
+}
+
+// Chunks of chunk_size items (but the last one), with one edge per item
+// There is always at least one chunk (possibly empty)
+GenerationChunk* createRegularChunks (int64_t nb_items, int64_t chunk_size, int64_t* nb_chunks)
+{
+	if (chunk_size < 1)
+		chunk_size = 1;
+
+	*nb_chunks = nb_items > 0 ? (nb_items + chunk_size - 1) / chunk_size : 1;
+
+	GenerationChunk* chunks = calloc(*nb_chunks, sizeof(GenerationChunk));
+	CHECK_MALLOC(chunks);
+
+	for (int64_t c = 0; c < *nb_chunks; c++)
+	{
+		GenerationChunk* chunk = &chunks[c];
+		chunk->first_item = c * chunk_size;
+		chunk->nb_items   = nb_items - chunk->first_item < chunk_size
+						  ? nb_items - chunk->first_item
+						  : chunk_size;
+		chunk->nb_edges   = chunk->nb_items;
+	}
+
+	return chunks;
+}
+
+// Returns the number of edges of the graph (UNKNOWN_NB_EDGES if it is only
+// known once the chunks have been generated)
+int64_t createModelChunks (GenerationState* state, double density)
+{
+	int nb_vertices  = state->nb_vertices;
+	int64_t nb_items = nb_vertices;
+	int64_t nb_edges = UNKNOWN_NB_EDGES;
+
+	switch (state->model)
+	{
+		case GRID_MODEL:
+			nb_items = computeNbGridEdges(nb_vertices, state->grid_width);
+			nb_edges = computeNbEdges(nb_items, density);
+			break;
+
+		case RMAT_MODEL:
+			nb_edges = computeNbEdges(computeNbPairs(nb_vertices), density);
+			break;
+
+		case BARABASI_ALBERT_MODEL:
+			nb_edges = (int64_t) nb_vertices * state->nb_attachments;
+			break;
+
+		case GEOMETRIC_MODEL:
+			break;
+
+		default:
+			nb_items = computeNbPairs(nb_vertices);
+			nb_edges = computeNbEdges(nb_items, density);
+	}
+
+	// The spanning tree of a connected graph is part of its edges
+	if (state->connected)
+	{
+		if (state->model == BARABASI_ALBERT_MODEL || state->model == GEOMETRIC_MODEL)
+		{
+			fprintf(stderr, "Error: connected graphs are only available for the uniform,"
+							" grid and R-MAT models.\n");
+			exit(1);
+		}
+
+		if (nb_edges < nb_vertices - 1)
+		{
+			fprintf(stderr, "Error: a connected graph needs at least %d edges"
+							" (%" PRId64 " requested).\n", nb_vertices - 1, nb_edges);
+			exit(1);
+		}
+
+		buildRandomSpanningTree(state);
+	}
+
+	switch (state->model)
+	{
+		case RMAT_MODEL:
+			state->chunks = createRegularChunks(nb_edges - state->nb_tree_items,
+												NB_EDGES_PER_CHUNK, &state->nb_chunks);
+			break;
+
+		case BARABASI_ALBERT_MODEL:
+			state->chunks = createRegularChunks(nb_vertices, nb_vertices, &state->nb_chunks);
+			state->chunks[0].nb_edges = nb_edges;
+			break;
+
+		case GEOMETRIC_MODEL:
+			// About (n - 1) * density / 2 edges per vertex
+			placeVerticesInCells(state);
+			nb_items = (int64_t) (NB_EDGES_PER_CHUNK / (1.0 + (nb_vertices - 1) * density / 2.0));
+			state->chunks = createRegularChunks(nb_vertices, nb_items, &state->nb_chunks);
+			break;
+
+		default:
+			state->chunks = splitItemsIntoChunks(state->seed, nb_items,
+												 nb_edges - state->nb_tree_items,
+												 state->tree_items, state->nb_tree_items,
+												 &state->nb_chunks);
+	}
+
+	if (state->connected)
+		addSpanningTreeChunk(state);
+
+	return nb_edges;
+}
+
+// The chunk has its own random stream: its edges do not depend on the thread
+// which generates it
+void generateChunk (GenerationState* state, int64_t chunk_num)
+{
+	GenerationChunk* chunk = &state->chunks[chunk_num];
+
+	EdgeWriter writer;
+	writer.state 		   = state;
+	writer.buffer.bytes    = NULL;
+	writer.buffer.size 	   = 0;
+	writer.buffer.capacity = 0;
+	writer.nb_edges 	   = 0;
+	writer.first_item 	   = chunk->first_item;
+	writer.nb_skipped_items   = 0;
+	writer.next_excluded_item = chunk->first_excluded_item;
+	writer.end_excluded_item  = chunk->first_excluded_item + chunk->nb_excluded_items;
+	seedPrng(&writer.prng, state->seed, CHUNK_SIZES_STREAM + 1 + (uint64_t) chunk_num);
+
+	if (state->model == UNIFORM_MODEL || chunk->spanning_tree)
+		initPairCursor(&writer.cursor, chunk->first_item);
+
+	if (chunk->spanning_tree)
+	{
+		for (int64_t i = 0; i < state->nb_tree_items; i++)
+			writeSampledEdge(&writer, state->tree_items[i]);
+
+		chunk->nb_edges = writer.nb_edges;
+		chunk->buffer 	= writer.buffer;
+		return;
+	}
+
+	switch (state->model)
+	{
+		case RMAT_MODEL:
+			generateRMATEdges(&writer, chunk->nb_edges);
+			break;
+
+		case BARABASI_ALBERT_MODEL:
+			generateBarabasiAlbertEdges(&writer);
+			break;
+
+		case GEOMETRIC_MODEL:
+			generateGeometricEdges(&writer, chunk->first_item, chunk->nb_items);
+			break;
+
+		default:
+			sampleWithMethodD(&writer, chunk->nb_edges,
+							  chunk->nb_items - chunk->nb_excluded_items);
+	}
+
+	chunk->nb_edges = writer.nb_edges;
+	chunk->buffer 	= writer.buffer;
+}
+
+void generateChunksInParallel (int thread_num, int nb_threads, void* argument)
+{
+	GenerationState* state = argument;
+	(void) thread_num;
+	(void) nb_threads;
+
+	while (true)
+	{
+		int64_t chunk_num = __atomic_fetch_add(&state->next_chunk, 1, __ATOMIC_RELAXED);
+		if (chunk_num >= state->end_chunk)
+			break;
+
+		generateChunk(state, chunk_num);
+	}
+}
+
+// The generated graph only depends on the parameters and the seed
+// In the text format, every round of chunks is written as soon as it is
+// generated, if the number of edges is known in advance; otherwise, all the
+// chunks are kept until the end
+// Returns the number of edges (the checksum of the output is left in the state)
+int64_t generateGraph (GenerationState* state, double density, int nb_threads)
+{
+	int64_t nb_edges = createModelChunks(state, density);
+	state->checksum  = FNV_OFFSET_BASIS;
+	bool streamed 	 = state->format == TEXT_GRAPH_FORMAT && nb_edges != UNKNOWN_NB_EDGES;
+
+	if (nb_edges > INT_MAX)
+	{
+		fprintf(stderr, "Error: too many edges (%" PRId64 ").\n", nb_edges);
+		exit(1);
+	}
+
+	char first_line[64];
+	char* end = formatInteger(first_line, state->nb_vertices);
+	*(end++)  = ' ';
+
+	if (streamed)
+	{
+		end 	 = formatInteger(end, nb_edges);
+		*(end++) = '\n';
+		writeToFile(state, first_line, (size_t) (end - first_line));
+	}
+
+	int64_t nb_chunks_per_round = (int64_t) nb_threads * NB_CHUNKS_PER_THREAD_AND_ROUND;
+
+	for (int64_t first_chunk = 0; first_chunk < state->nb_chunks; first_chunk += nb_chunks_per_round)
+	{
+		state->first_chunk = first_chunk;
+		state->end_chunk   = first_chunk + nb_chunks_per_round < state->nb_chunks
+						   ? first_chunk + nb_chunks_per_round
+						   : state->nb_chunks;
+		state->next_chunk  = first_chunk;
+
+		runInParallel(nb_threads, generateChunksInParallel, state);
+
+		if (streamed)
+			for (int64_t c = state->first_chunk; c < state->end_chunk; c++)
+			{
+				OutputBuffer* buffer = &state->chunks[c].buffer;
+				writeToFile(state, buffer->bytes, buffer->size);
+				free(buffer->bytes);
+				buffer->bytes = NULL;
+			}
+	}
+
+	if (nb_edges == UNKNOWN_NB_EDGES)
+	{
+		nb_edges = 0;
+		for (int64_t c = 0; c < state->nb_chunks; c++)
+			nb_edges += state->chunks[c].nb_edges;
+
+		if (nb_edges > INT_MAX)
+		{
+			fprintf(stderr, "Error: too many edges (%" PRId64 ").\n", nb_edges);
+			exit(1);
+		}
+	}
+
+	if (state->format == BINARY_GRAPH_FORMAT)
+		writeBinaryGraph(state, nb_edges);
+	else if (!streamed)
+	{
+		end 	 = formatInteger(end, nb_edges);
+		*(end++) = '\n';
+		writeToFile(state, first_line, (size_t) (end - first_line));
+
+		for (int64_t c = 0; c < state->nb_chunks; c++)
+			writeToFile(state, state->chunks[c].buffer.bytes, state->chunks[c].buffer.size);
+	}
+
+	return nb_edges;
+}
+
+void freeGenerationState (GenerationState* state)
+{
+	for (int64_t c = 0; c < state->nb_chunks; c++)
+		free(state->chunks[c].buffer.bytes);
+
+	free(state->chunks);
+	free(state->tree_items);
+	free(state->coordinates);
+	free(state->cell_offsets);
+	free(state->cell_vertices);
+}
+
+//------------------------------------------------------------------------------
+// CORPUS
+//------------------------------------------------------------------------------
+
+char* getModelName (GraphModel model)
+{
+	switch (model)
+	{
+		case GRID_MODEL:
+			return "grid";
+		case RMAT_MODEL:
+			return "rmat";
+		case BARABASI_ALBERT_MODEL:
+			return "ba";
+		case GEOMETRIC_MODEL:
+			return "geometric";
+		default:
+			return "uniform";
+	}
+}
+
+// Path of a file of the output directory (to be freed by the caller)
+char* getCorpusFilePath (char* output_directory, char* file_name)
+{
+	size_t length = strlen(output_directory) + strlen(file_name) + 2;
+	char* path = malloc(length);
+	CHECK_MALLOC(path);
+
+	snprintf(path, length, "%s/%s", output_directory, file_name);
+	return path;
+}
+
+// Every thread takes the graphs one by one, and generates each of them in its
+// own state (a copy of the parameters, with the seed of the graph)
+void generateCorpusGraphs (int thread_num, int nb_threads, void* argument)
+{
+	CorpusState* corpus = argument;
+	(void) thread_num;
+	(void) nb_threads;
 
-			for (int j = 0; j < (i + 1); j++)
-				edges[i][j] = no_edge_weight;
+	while (true)
+	{
+		int graph_num = __atomic_fetch_add(&corpus->next_graph, 1, __ATOMIC_RELAXED);
+		if (graph_num >= corpus->nb_graphs)
+			break;
+
+		char file_name[32];
+		snprintf(file_name, sizeof(file_name), "%s%d", CORPUS_GRAPH_PREFIX, graph_num);
+		char* path = getCorpusFilePath(corpus->output_directory, file_name);
+
+		GenerationState state = *(corpus->parameters);
+		state.seed 	 = corpus->seeds[graph_num];
+		state.output = fopen(path, "wb");
+
+		if (state.output == NULL)
+		{
+			fprintf(stderr, "Error: %s cannot be created.\n", path);
+			exit(1);
 		}
+
+		corpus->nb_edges[graph_num]  = generateGraph(&state, corpus->density,
+													 corpus->nb_threads_per_graph);
+		corpus->checksums[graph_num] = state.checksum;
+
+		fclose(state.output);
+		freeGenerationState(&state);
+		free(path);
+	}
+}
+
+// The manifest lists the parameters of the corpus, then the seed, the number
+// of edges and the checksum (FNV-1a of the file) of every graph
+void writeCorpusManifest (CorpusState* corpus, uint64_t corpus_seed)
+{
+	GenerationState* parameters = corpus->parameters;
+	char* path = getCorpusFilePath(corpus->output_directory, CORPUS_MANIFEST_NAME);
+	FILE* manifest = fopen(path, "w");
+
+	if (manifest == NULL)
+	{
+		fprintf(stderr, "Error: %s cannot be created.\n", path);
+		exit(1);
 	}
 
-	// Random edge addition (or deletion)
-	int nb_iterations = remove_edges
-					  ? ((nb_vertices * (nb_vertices + 1)) / 2) - nb_edges
-					  : nb_edges;
+	fprintf(manifest, "model %s\n", getModelName(parameters->model));
+	fprintf(manifest, "format %s\n",
+			parameters->format == BINARY_GRAPH_FORMAT ? "binary" : "text");
+	fprintf(manifest, "connected %d\n", parameters->connected ? 1 : 0);
+	fprintf(manifest, "nb_vertices %d\n", parameters->nb_vertices);
+	fprintf(manifest, "density %.17g\n", corpus->density);
+	fprintf(manifest, "min_weight %d\n", parameters->min_weight);
+	fprintf(manifest, "max_weight %d\n", parameters->max_weight);
+	fprintf(manifest, "grid_width %d\n", parameters->grid_width);
+	fprintf(manifest, "rmat_probabilities %.17g,%.17g,%.17g\n",
+			parameters->rmat_probabilities[0], parameters->rmat_probabilities[1],
+			parameters->rmat_probabilities[2]);
+	fprintf(manifest, "seed %" PRIu64 "\n", corpus_seed);
+	fprintf(manifest, "nb_graphs %d\n", corpus->nb_graphs);
 
-	for (int i = 0; i < nb_iterations; i++)
-		generateNewRandomEdge(edges, nb_vertices, no_edge_weight,
-							  min_weight, max_weight, remove_edges);
+	for (int i = 0; i < corpus->nb_graphs; i++)
+		fprintf(manifest, "%s%d %" PRIu64 " %" PRId64 " %016" PRIx64 "\n", CORPUS_GRAPH_PREFIX, i,
+				corpus->seeds[i], corpus->nb_edges[i], corpus->checksums[i]);
 
-	// Finally return the edges of the newly built random graph
-	return edges;
+	fclose(manifest);
+	free(path);
 }
 
-void freeGraph (int** edges, int nb_vertices)
+// The graphs are generated in parallel (the threads which are left when there
+// are fewer graphs than threads help to generate each graph)
+// The seeds of the graphs are the successive outputs of SplitMix64 seeded with
+// the seed of the corpus: a graph can be generated again on its own
+void generateCorpus (GenerationState* parameters, double density, int nb_graphs,
+					 char* output_directory, int nb_threads)
 {
-	for (int i = 0; i < nb_vertices; i++)
-		free(edges[i]);
+	if (mkdir(output_directory, 0755) != 0 && errno != EEXIST)
+	{
+		fprintf(stderr, "Error: %s cannot be created.\n", output_directory);
+		exit(1);
+	}
+
+	CorpusState corpus;
+	corpus.parameters 	    = parameters;
+	corpus.density 		    = density;
+	corpus.output_directory = output_directory;
+	corpus.nb_graphs 	    = nb_graphs;
+	corpus.next_graph 	    = 0;
+
+	int nb_workers = nb_graphs < nb_threads ? nb_graphs : nb_threads;
+	corpus.nb_threads_per_graph = nb_threads / nb_workers;
+
+	corpus.seeds 	 = malloc(nb_graphs * sizeof(uint64_t));
+	corpus.nb_edges  = malloc(nb_graphs * sizeof(int64_t));
+	corpus.checksums = malloc(nb_graphs * sizeof(uint64_t));
+	CHECK_MALLOC(corpus.seeds);
+	CHECK_MALLOC(corpus.nb_edges);
+	CHECK_MALLOC(corpus.checksums);
 
-	free(edges);
+	uint64_t splitmix_state = parameters->seed;
+	for (int i = 0; i < nb_graphs; i++)
+		corpus.seeds[i] = getNextSplitMix64(&splitmix_state);
+
+	runInParallel(nb_workers, generateCorpusGraphs, &corpus);
+	writeCorpusManifest(&corpus, parameters->seed);
+
+	free(corpus.seeds);
+	free(corpus.nb_edges);
+	free(corpus.checksums);
 }
 
-void printGraph (FILE* output, int** edges, int nb_vertices, int nb_edges, int no_edge_weight)
+//------------------------------------------------------------------------------
+
+GraphModel parseModelName (char* name, char* argv[])
 {
-	// First, print the number of vertices and the number of edges
-	fprintf(output, "%d %d\n", nb_vertices, nb_edges);
+	if (strcmp(name, "uniform") == 0)
+		return UNIFORM_MODEL;
+	if (strcmp(name, "grid") == 0)
+		return GRID_MODEL;
+	if (strcmp(name, "rmat") == 0)
+		return RMAT_MODEL;
+	if (strcmp(name, "ba") == 0)
+		return BARABASI_ALBERT_MODEL;
+	if (strcmp(name, "geometric") == 0)
+		return GEOMETRIC_MODEL;
 
-	// Then, print all the edges and their weights
-	for (int i = 0; i < nb_vertices; i++)
-		for (int j = 0; j < (i + 1); j++)
-			if (edges[i][j] != no_edge_weight)
-				fprintf(output, "%d %d %d\n", i, j, edges[i][j]);
+	printUsageAndExit(argv);
+	return UNIFORM_MODEL;
 }
 
 void printUsageAndExit (char* argv[])
 {
 	fprintf(stderr,
-			"Usage: %s <nb vertices [1-]> <density (0-1)> <min weight> <max weight>\n",
-			argv[0]);
+			"Usage: %s [options] <nb vertices [1-]> <density (0-1)> <min weight> <max weight>\n"
+			"Options:\n"
+			"  --seed <seed>           seed of the generation (same seed, same graph)\n"
+			"  --threads <nb threads>  number of generating threads\n"
+			"  --binary                binary output (see graph.h)\n"
+			"  --connected             connected graph (a random spanning tree is laid\n"
+			"                          down first; uniform, grid and rmat models)\n"
+			"  --model <model>         uniform (default), grid, rmat, ba or geometric\n"
+			"  --width <width>         width of the grid (default: square grid)\n"
+			"  --rmat <a>,<b>,<c>      probabilities of the R-MAT quadrants"
+			" (default: %g,%g,%g)\n"
+			"  --corpus <nb graphs>    generate graph_0, graph_1... and a manifest\n"
+			"  --output-dir <path>     directory of the corpus\n"
+			"The density is the fraction of the pairs of vertices which are edges, but\n"
+			"for the grid model, where it is the fraction of the grid edges kept.\n"
+			"The rmat and ba models give multigraphs: loops and parallel edges are kept,\n"
+			"so the density sets the number of drawn edges, not of distinct ones.\n",
+			argv[0], DEFAULT_RMAT_A, DEFAULT_RMAT_B, DEFAULT_RMAT_C);
 	exit(1);
 }
 
 int main (int argc, char* argv[])
 {
-	srand(time(0) + clock());
+	GenerationState state;
+	memset(&state, 0, sizeof(state));
+
+	// Default seed (the generation is then not reproducible)
+	state.seed 	   = ((uint64_t) time(0) << 32) ^ (uint64_t) clock();
+	state.model    = UNIFORM_MODEL;
+	state.format   = TEXT_GRAPH_FORMAT;
+	state.rmat_probabilities[0] = DEFAULT_RMAT_A;
+	state.rmat_probabilities[1] = DEFAULT_RMAT_B;
+	state.rmat_probabilities[2] = DEFAULT_RMAT_C;
+	int nb_threads = getNbAvailableCores();
+
+	int nb_corpus_graphs = 0;
+	char* output_directory = NULL;
+
+	// Try to get the options and arguments; print usage and exit if it fails
+	char* arguments[4];
+	int nb_arguments = 0;
 
-	// Try to get the arguments; print usage and exit if it fails
-	if (argc != 1 + 4)
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%" SCNu64, &state.seed) != 1)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d", &nb_threads) != 1 || nb_threads <= 0)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--binary") == 0)
+			state.format = BINARY_GRAPH_FORMAT;
+		else if (strcmp(argv[i], "--connected") == 0)
+			state.connected = true;
+		else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d", &nb_corpus_graphs) != 1 || nb_corpus_graphs <= 0)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc)
+			output_directory = argv[++i];
+		else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc)
+			state.model = parseModelName(argv[++i], argv);
+		else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%d", &state.grid_width) != 1 || state.grid_width <= 0)
+				printUsageAndExit(argv);
+		}
+		else if (strcmp(argv[i], "--rmat") == 0 && i + 1 < argc)
+		{
+			double* probabilities = state.rmat_probabilities;
+			if (sscanf(argv[++i], "%lf,%lf,%lf", &probabilities[0], &probabilities[1],
+					   &probabilities[2]) != 3
+			||  probabilities[0] < 0 || probabilities[1] < 0 || probabilities[2] < 0
+			||  probabilities[0] + probabilities[1] + probabilities[2] > 1)
+				printUsageAndExit(argv);
+		}
+		else if (strncmp(argv[i], "--", 2) == 0 || nb_arguments == 4)
+			printUsageAndExit(argv);
+		else
+			arguments[nb_arguments++] = argv[i];
+	}
+
+	if (nb_arguments != 4 || (nb_corpus_graphs > 0) != (output_directory != NULL))
 		printUsageAndExit(argv);
 
 	int nb_read_values = 0;
-	int nb_vertices, min_weight, max_weight;
 	double density;
 
-	nb_read_values += sscanf(argv[1], "%d",  &nb_vertices);
-	nb_read_values += sscanf(argv[2], "%lf", &density);
-	nb_read_values += sscanf(argv[3], "%d",  &min_weight);
-	nb_read_values += sscanf(argv[4], "%d",  &max_weight);
+	nb_read_values += sscanf(arguments[0], "%d",  &state.nb_vertices);
+	nb_read_values += sscanf(arguments[1], "%lf", &density);
+	nb_read_values += sscanf(arguments[2], "%d",  &state.min_weight);
+	nb_read_values += sscanf(arguments[3], "%d",  &state.max_weight);
 
 	if (nb_read_values != 4)
 		printUsageAndExit(argv);
-	if (density < 0 || density > 1 || nb_vertices <= 0)
+	if (density < 0 || density > 1 || state.nb_vertices <= 0
+	||  state.min_weight > state.max_weight)
 		printUsageAndExit(argv);
 
-	// Generate a random graph according to the given parameters
-	// The weight of an absent edge is set to min_weight - 1
-	int no_edge_weight = min_weight - 1;
+	// Parameters derived from the number of vertices and the density
+	int nb_vertices = state.nb_vertices;
+
+	if (state.grid_width == 0)
+		state.grid_width = (int) ceil(sqrt((double) nb_vertices));
+
+	state.rmat_probabilities[3] = 1.0 - state.rmat_probabilities[0]
+								- state.rmat_probabilities[1] - state.rmat_probabilities[2];
+	while (((int64_t) 1 << state.rmat_scale) < nb_vertices)
+		(state.rmat_scale)++;
 
-	int** edges = generateRandomGraph(nb_vertices, density, no_edge_weight,
-									  min_weight, max_weight);
+	state.nb_attachments = (int) computeNbEdges(nb_vertices + 1, density / 2.0);
+	if (state.nb_attachments < 1)
+		state.nb_attachments = 1;
 
-	// Print the generated graph on the standard output
-	int nb_edges = computeNbEdges(nb_vertices, density);
-	printGraph(stdout, edges, nb_vertices, nb_edges, no_edge_weight);
+	state.radius = sqrt(density / M_PI);
 
-	// Free the graph and exit
-	freeGraph(edges, nb_vertices);
+	// Write the corpus, or print the graph on the standard output
+	if (nb_corpus_graphs > 0)
+		generateCorpus(&state, density, nb_corpus_graphs, output_directory, nb_threads);
+	else
+	{
+		state.output = stdout;
+		generateGraph(&state, density, nb_threads);
+		freeGenerationState(&state);
+	}
 
 	return 0;
 }
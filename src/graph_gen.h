@@ -5,17 +5,244 @@
 #ifndef _GRAPH_GEN_H
 #define _GRAPH_GEN_H
 
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "prng.h"
+
+// Ratio n / N under which Vitter's method D is used instead of method A
+// (the value recommended by Vitter)
+#define METHOD_D_THRESHOLD_RATIO 13
+
+// Expected number of edges in a chunk of the pair space
+// (the chunks are the units of work of the parallel generation)
+#define NB_EDGES_PER_CHUNK 65536
+
+// Number of chunks generated by each thread before they are written
+#define NB_CHUNKS_PER_THREAD_AND_ROUND 4
+
+// Expected number of edges (above the minimum) under which the number of edges
+// of a chunk is drawn exactly, rather than from a normal approximation
+#define HYPERGEOMETRIC_INVERSION_THRESHOLD 64.0
+
+// Number of edges of a model which is only known after the generation
+#define UNKNOWN_NB_EDGES -1
+
+// Random stream used to split the edges among the chunks
+// (the chunk c uses the stream c + 1)
+#define CHUNK_SIZES_STREAM 0
+
+// Random streams used to place the vertices of the geometric model, and to
+// draw the spanning tree of a connected graph
+#define VERTEX_POSITIONS_STREAM UINT64_MAX
+#define SPANNING_TREE_STREAM 	(UINT64_MAX - 1)
+
+// Names of the files of a corpus (in its output directory)
+#define CORPUS_GRAPH_PREFIX  "graph_"
+#define CORPUS_MANIFEST_NAME "manifest"
+
+// Default probabilities of the quadrants of the R-MAT model (Graph500 values)
+#define DEFAULT_RMAT_A 0.57
+#define DEFAULT_RMAT_B 0.19
+#define DEFAULT_RMAT_C 0.19
+
+// Models of random graphs (the meaning of the density depends on the model):
+// - uniform: m = density * N edges among the N pairs (Erdos-Renyi)
+// - grid: 2D grid (road-like, local edges), of which a fraction density of
+//   the edges is kept
+// - R-MAT: m = density * N edges drawn by recursive choices of quadrants of
+//   the adjacency matrix (power-law degrees; loops and parallel edges are kept)
+// - Barabasi-Albert: every vertex is attached to k = density * (n + 1) / 2
+//   (at least 1) earlier vertices, chosen with a probability proportional to
+//   their degree (loops and parallel edges are kept)
+// - random geometric: vertices are points of the unit square, linked when
+//   their distance is below a radius r such that pi * r^2 = density (the
+//   weights grow with the distance)
+typedef enum GraphModel
+{
+	UNIFORM_MODEL,
+	GRID_MODEL,
+	RMAT_MODEL,
+	BARABASI_ALBERT_MODEL,
+	GEOMETRIC_MODEL
+} GraphModel;
+
+// Position in the space of the pairs of vertices (origin >= destination),
+// numbered row by row: (0, 0), (1, 0), (1, 1), (2, 0)...
+typedef struct PairCursor
+{
+	int origin;
+	int64_t row_start; // Index of (origin, 0)
+} PairCursor;
+
+// Formats of the generated graph (see graph.h for the binary format)
+typedef enum GraphFormat
+{
+	TEXT_GRAPH_FORMAT,
+	BINARY_GRAPH_FORMAT
+} GraphFormat;
+
+// Edges generated in a chunk: their text lines, or their (origin, destination,
+// weight) triples of int32 in the binary format
+typedef struct OutputBuffer
+{
+	char* bytes;
+	size_t size;
+	size_t capacity;
+} OutputBuffer;
+
+// Contiguous range of items (pairs, grid edges, edge draws or vertices,
+// depending on the model), and the number of edges generated from it
+// Items of the spanning tree (connected graphs) are excluded from the ranges,
+// and written by a chunk of their own
+typedef struct GenerationChunk
+{
+	int64_t first_item;
+	int64_t nb_items;
+	int64_t nb_edges;
+	int64_t first_excluded_item; // Position in the sorted excluded items
+	int64_t nb_excluded_items;
+	bool spanning_tree;
+	OutputBuffer buffer;
+} GenerationChunk;
+
+// Parameters of the generation, and state shared by the generating threads
+// The threads take the chunks of the current round [first_chunk, end_chunk[
+// one by one; the rounds are written in order of the chunks, so that the
+// output only depends on the seed (and not on the number of threads)
+typedef struct GenerationState
+{
+	GraphModel model;
+	GraphFormat format;
+	uint64_t seed;
+
+	// Output, and checksum (FNV-1a) of what has been written on it
+	FILE* output;
+	uint64_t checksum;
+
+	int nb_vertices;
+	int min_weight;
+	int max_weight;
+
+	// Connected graphs: items of the spanning tree (sorted)
+	bool connected;
+	int64_t* tree_items;
+	int64_t nb_tree_items;
+
+	// Grid model
+	int grid_width;
+
+	// R-MAT model: probabilities of the 4 quadrants, on 2^scale vertices
+	double rmat_probabilities[4];
+	int rmat_scale;
+
+	// Barabasi-Albert model: number of edges added with every vertex
+	int nb_attachments;
+
+	// Geometric model: positions of the vertices, and vertices sorted by
+	// cell of a square grid whose cells are (at least) as wide as the radius
+	double radius;
+	double* coordinates; // x0, y0, x1, y1...
+	int nb_cells_per_side;
+	int* cell_offsets;
+	int* cell_vertices;
+
+	GenerationChunk* chunks;
+	int64_t nb_chunks;
+
+	int64_t first_chunk;
+	int64_t end_chunk;
+	int64_t next_chunk;
+} GenerationState;
+
+// Corpus of graphs generated with the same parameters and different seeds
+// The threads take the graphs one by one (each graph being generated by
+// nb_threads_per_graph threads)
+typedef struct CorpusState
+{
+	GenerationState* parameters;
+	double density;
+	char* output_directory;
+	int nb_graphs;
+	int nb_threads_per_graph;
+
+	uint64_t* seeds;
+	int64_t* nb_edges;
+	uint64_t* checksums;
+
+	int next_graph;
+} CorpusState;
+
+// Output of the edges of a chunk
+// (the sampled indexes are relative to the first item of the chunk, and do
+// not count the excluded items)
+typedef struct EdgeWriter
+{
+	GenerationState* state;
+	OutputBuffer buffer;
+	int64_t nb_edges;
+	PairCursor cursor;
+	int64_t first_item;
+	int64_t next_excluded_item;
+	int64_t end_excluded_item;
+	int64_t nb_skipped_items;
+	Prng prng;
+} EdgeWriter;
+
 //------------------------------------------------------------------------------
 
-void swapValues (int* x, int* y);
-int getRandomBoundedInt (int min, int max);
-int computeNbEdges (int nb_vertices, double density);
-void generateNewRandomEdge (int** edges, int nb_vertices, int no_edge_weight,
-							int min_weight, int max_weight, bool remove_edge);
-int** generateRandomGraph (int nb_vertices, double density, int no_edge_weight,
-						   int min_weight, int max_weight);
-void freeGraph (int** edges, int nb_vertices);
-void printGraph (FILE* output, int** edges, int nb_vertices, int nb_edges, int no_edge_weight);
+double computeLogFactorial (int64_t x);
+double computeLogFactorialRatio (int64_t a, int64_t b);
+double getRandomNormalDouble (Prng* prng);
+int64_t drawHypergeometric (Prng* prng, int64_t nb_draws, int64_t nb_successes,
+							int64_t population);
+
+int64_t computeNbPairs (int nb_vertices);
+int64_t computeNbEdges (int64_t nb_items, double density);
+
+void initPairCursor (PairCursor* cursor, int64_t pair_index);
+void movePairCursor (PairCursor* cursor, int64_t pair_index);
+
+char* formatInteger (char* position, int64_t value);
+char* reserveOutputBuffer (OutputBuffer* buffer, size_t size);
+void writeToFile (GenerationState* state, void* bytes, size_t size);
+void writeEdge (EdgeWriter* writer, int origin, int destination, int weight);
+void writeSampledEdge (EdgeWriter* writer, int64_t index);
+void writeBinaryGraph (GenerationState* state, int64_t nb_edges);
+
+void sampleWithMethodA (EdgeWriter* writer, int64_t nb_samples, int64_t nb_pairs,
+						int64_t current_index);
+void sampleWithMethodD (EdgeWriter* writer, int64_t nb_samples, int64_t nb_pairs);
+
+int64_t computeNbGridEdges (int nb_vertices, int width);
+void getGridEdge (int nb_vertices, int width, int64_t index, int* origin, int* destination);
+void generateRMATEdges (EdgeWriter* writer, int64_t nb_edges);
+void generateBarabasiAlbertEdges (EdgeWriter* writer);
+void placeVerticesInCells (GenerationState* state);
+void generateGeometricEdges (EdgeWriter* writer, int64_t first_vertex, int64_t nb_vertices);
+
+int compareItems (const void* item_1, const void* item_2);
+void buildRandomSpanningTree (GenerationState* state);
+void addSpanningTreeChunk (GenerationState* state);
+
+GenerationChunk* splitItemsIntoChunks (uint64_t seed, int64_t nb_items, int64_t nb_edges,
+									   int64_t* excluded_items, int64_t nb_excluded_items,
+									   int64_t* nb_chunks);
+GenerationChunk* createRegularChunks (int64_t nb_items, int64_t chunk_size, int64_t* nb_chunks);
+int64_t createModelChunks (GenerationState* state, double density);
+void generateChunk (GenerationState* state, int64_t chunk_num);
+void generateChunksInParallel (int thread_num, int nb_threads, void* state);
+int64_t generateGraph (GenerationState* state, double density, int nb_threads);
+void freeGenerationState (GenerationState* state);
+
+char* getModelName (GraphModel model);
+char* getCorpusFilePath (char* output_directory, char* file_name);
+void generateCorpusGraphs (int thread_num, int nb_threads, void* corpus);
+void writeCorpusManifest (CorpusState* corpus, uint64_t corpus_seed);
+void generateCorpus (GenerationState* parameters, double density, int nb_graphs,
+					 char* output_directory, int nb_threads);
+
+GraphModel parseModelName (char* name, char* argv[]);
 void printUsageAndExit (char* argv[]);
 
 #endif
@@ -1,118 +1,184 @@
 //------------------------------------------------------------------------------
-// LINKED & PRIORITY LISTS
+// STACKS & QUEUES
 //------------------------------------------------------------------------------
-// Implementation of two kinds of linked lists:
-// - basic linked lists
-// - simple priority (linked) lists
+// Implementation of two array-backed containers of integers:
+// - stacks (growable arrays)
+// - double-ended queues (growable ring buffers)
+// The arrays are doubled when they are full: every operation is amortized
+// O(1), and there is no allocation per element.
 //------------------------------------------------------------------------------
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <stdbool.h>
 #include "toolbox.h"
 #include "list.h"
 
+#define INITIAL_CAPACITY 16
+
 //------------------------------------------------------------------------------
-// Linked list
+// Stack
 //------------------------------------------------------------------------------
 
-List* createList () // O(1)
+// Nothing is allocated before the first push
+void initStack (Stack* stack) // O(1)
 {
-	List* res = malloc(sizeof(List));
+	stack->elements = NULL;
+	stack->size 	= 0;
+	stack->capacity = 0;
+}
+
+Stack* createStack () // O(1)
+{
+	Stack* res = malloc(sizeof(Stack));
 	CHECK_MALLOC(res);
 
-	res->first = NULL;
+	initStack(res);
 	return res;
 }
 
-bool listIsEmpty (List* L) // O(1)
-//the empty List is List with first = NULL
+void freeStackContent (Stack* stack) // O(1)
+{
+	free(stack->elements);
+	initStack(stack);
+}
+
+void freeStack (Stack* stack) // O(1)
+{
+	free(stack->elements);
+	free(stack);
+}
+
+bool stackIsEmpty (Stack* stack) // O(1)
 {
-	return (L->first == NULL);
+	return stack->size == 0;
 }
 
+void reserveStackCapacity (Stack* stack, int capacity) // O(size)
+{
+	if (capacity <= stack->capacity)
+		return;
 
-void addElementToList (List* L, int x) // O(1)
+	stack->elements = realloc(stack->elements, capacity * sizeof(int));
+	CHECK_MALLOC(stack->elements);
+	stack->capacity = capacity;
+}
+
+void pushToStack (Stack* stack, int x) // amortized O(1)
 {
-	ListElt* new_first = malloc(sizeof(ListElt));
-	CHECK_MALLOC(new_first);
+	if (stack->size == stack->capacity)
+		reserveStackCapacity(stack, stack->capacity == 0 ? INITIAL_CAPACITY : 2 * stack->capacity);
 
-	new_first->val  = x;
-	new_first->next = L->first;
-	L->first = new_first;
+	stack->elements[stack->size] = x;
+	(stack->size)++;
 }
 
-int popFromList (List* L) // O(1)
+// The stack must not be empty
+int popFromStack (Stack* stack) // O(1)
 {
-	ListElt* elt = L->first;
-	L->first 	 = elt->next;
+	assert(stack->size > 0);
 
-	return elt->val;
+	(stack->size)--;
+	return stack->elements[stack->size];
 }
 
-void concatTwoLists (List* L1 , List* L2) // O(|L2|) 
+// Move all the elements of stack_2 on top of stack_1 (stack_2 becomes empty)
+void concatTwoStacks (Stack* stack_1, Stack* stack_2) // O(|stack_2|)
 {
-	while (! listIsEmpty (L2))
-	{
-		int elt = popFromList(L2);
-		addElementToList(L1, elt);
-	}
+	reserveStackCapacity(stack_1, stack_1->size + stack_2->size);
+
+	if (stack_2->size > 0)
+		memcpy(&stack_1->elements[stack_1->size], stack_2->elements, stack_2->size * sizeof(int));
+
+	stack_1->size += stack_2->size;
+	stack_2->size  = 0;
 }
 
 //------------------------------------------------------------------------------
-// Basic (linked) priority list
+// Queue
 //------------------------------------------------------------------------------
 
-/*
-PrioList* createPrioList () // O(1)
+// Nothing is allocated before the first push
+void initQueue (Queue* queue) // O(1)
+{
+	queue->elements = NULL;
+	queue->capacity = 0;
+	queue->first 	= 0;
+	queue->size 	= 0;
+}
+
+Queue* createQueue () // O(1)
 {
-	PrioList* res = malloc(sizeof(PrioList));
+	Queue* res = malloc(sizeof(Queue));
 	CHECK_MALLOC(res);
 
-	res->first = NULL;
+	initQueue(res);
 	return res;
 }
 
-bool prioListIsEmpty (PrioList* P) // O(1)
+void freeQueueContent (Queue* queue) // O(1)
 {
-	return (P->first == NULL);
+	free(queue->elements);
+	initQueue(queue);
 }
 
-void addElementToPrioList (PrioList* P, Prio x ) // O(1)
+void freeQueue (Queue* queue) // O(1)
 {
-	PrioListElt* new_elt = malloc(sizeof(PrioListElt));
-	CHECK_MALLOC(new_elt);
+	free(queue->elements);
+	free(queue);
+}
 
-	new_elt->val = &x;
-	new_elt->next = P->first;
-	P->first = new_elt;
+bool queueIsEmpty (Queue* queue) // O(1)
+{
+	return queue->size == 0;
 }
 
-Prio extractMinFromPrioList (PrioList* P) // O(|P|)
+// Double the capacity (the content is moved at the beginning of the buffer)
+void growQueue (Queue* queue) // O(size)
 {
-	PrioListElt* min = malloc(sizeof(PrioListElt));
-	CHECK_MALLOC(min);
+	int capacity = queue->capacity == 0 ? INITIAL_CAPACITY : 2 * queue->capacity;
+
+	int* elements = malloc(capacity * sizeof(int));
+	CHECK_MALLOC(elements);
+
+	for (int i = 0; i < queue->size; i++)
+		elements[i] = queue->elements[(queue->first + i) & (queue->capacity - 1)];
+
+	free(queue->elements);
+	queue->elements = elements;
+	queue->capacity = capacity;
+	queue->first 	= 0;
+}
+
+void pushBackToQueue (Queue* queue, int x) // amortized O(1)
+{
+	if (queue->size == queue->capacity)
+		growQueue(queue);
+
+	queue->elements[(queue->first + queue->size) & (queue->capacity - 1)] = x;
+	(queue->size)++;
+}
+
+void pushFrontToQueue (Queue* queue, int x) // amortized O(1)
+{
+	if (queue->size == queue->capacity)
+		growQueue(queue);
+
+	queue->first = (queue->first - 1) & (queue->capacity - 1);
+	queue->elements[queue->first] = x;
+	(queue->size)++;
+}
+
+// The queue must not be empty
+int popFrontFromQueue (Queue* queue) // O(1)
+{
+	assert(queue->size > 0);
+
+	int x = queue->elements[queue->first];
+	queue->first = (queue->first + 1) & (queue->capacity - 1);
+	(queue->size)--;
 
-	min = P->first;
-	P->first = min->next;
-	if (prioListIsEmpty( P))
-	{
-		return *min->val;
-	}
-	else
-	{
-		Prio min2 = extractMinFromPrioList(P);
-		if (min2.key <= min->val->key)
-		{
-			addElementToPrioList(P,min2);
-			return *min->val;
-		}
-		else
-		{
-			addElementToPrioList(P, *min->val);
-			return min2;
-		}
-	}
+	return x;
 }
-*/
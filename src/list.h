@@ -1,5 +1,5 @@
 //------------------------------------------------------------------------------
-// LINKED & PRIORITY LISTS
+// STACKS & QUEUES
 //------------------------------------------------------------------------------
 
 #ifndef _LIST_H
@@ -7,52 +7,43 @@
 
 #include <stdbool.h>
 
-// Linked list
-typedef struct ListElt 
+// Stack (growable array)
+typedef struct Stack
 {
-	int val;
-	struct ListElt* next;
-} ListElt; 
- 
-typedef struct List
-{
-	ListElt* first;
-} List;
-
-// Priority List
-/*
-typedef struct Priority
-{
-	int elt;
-	int key;
-} Priority;
-
-typedef struct PrioListElt
-{
-	Prio* val;
-	struct PrioListElt* next;
-
-} PrioListElt;
+	int* elements;
+	int size;
+	int capacity;
+} Stack;
 
-typedef struct PrioList
+// Double-ended queue (growable ring buffer)
+typedef struct Queue
 {
-	PrioListElt* first;
-} PrioList;
-*/
+	int* elements;
+	int capacity; // Always a power of 2
+	int first;
+	int size;
+} Queue;
 
 //------------------------------------------------------------------------------
 
-List* createList ();
-bool listIsEmpty (List* L);
-void addElementToList (List* L, int x);
-int popFromList (List* L);
-void concatTwoLists (List* L1 , List* L2);
-
-/*
-PrioList* createPrioList ();
-bool prioListIsEmpty (PrioList* P);
-void addElementToPrioList (PrioList* P, Prio x );
-Prio extractMinFromPrioList (PrioList* P);
-*/
+void initStack (Stack* stack);
+Stack* createStack ();
+void freeStackContent (Stack* stack);
+void freeStack (Stack* stack);
+bool stackIsEmpty (Stack* stack);
+void reserveStackCapacity (Stack* stack, int capacity);
+void pushToStack (Stack* stack, int x);
+int popFromStack (Stack* stack);
+void concatTwoStacks (Stack* stack_1, Stack* stack_2);
+
+void initQueue (Queue* queue);
+Queue* createQueue ();
+void freeQueueContent (Queue* queue);
+void freeQueue (Queue* queue);
+bool queueIsEmpty (Queue* queue);
+void growQueue (Queue* queue);
+void pushBackToQueue (Queue* queue, int x);
+void pushFrontToQueue (Queue* queue, int x);
+int popFrontFromQueue (Queue* queue);
 
 #endif
@@ -5,9 +5,8 @@
 // The complexity computation functions are also called, and the results are
 // finally displayed in the terminal.
 //
-// The version using Fibonacci heaps is very likely to fail!
-// Besides, the computed complexity are not realistic (you can read more about
-// this in the related module/the readme file).
+// The computed complexity of the version using Fibonacci heaps is not
+// realistic (you can read more about this in the related module/the readme file).
 //------------------------------------------------------------------------------
 
 #include <stdio.h>
@@ -18,6 +17,7 @@
 #include "fibonacci_heap.h"
 #include "graph.h"
 #include "dijkstra.h"
+#include "small_weight_sssp.h"
 
 //------------------------------------------------------------------------------
 
@@ -26,7 +26,8 @@
 // so that two exec files can be compiled...
 
 // The USE_OPTIMIZED_VERSION preprocessor constant must be defined at compile-time
-// to use the version using Fibonacci heaps (even though it doesn't work well/at all?)
+// to use the version using Fibonacci heaps (replaced by a 0-1 BFS if all the
+// weights of the graph are 0 or 1)
 int main ()
 {
 	int connectivity_complexity = 0;
@@ -50,12 +51,22 @@ int main ()
 		printProgressMessage("[The graph is connected]\n");
 
 		#ifdef USE_OPTIMIZED_VERSION
-			printProgressMessage("[OPTIMIZED ALGORITHM - Distances from the given vertice]\n");
-			int* distances = dijkstra(graph, origin);
-			dijkstra_complexity += ComplexityOf_dijkstra(graph, origin);
+			int* distances;
+			if (graph->min_weight >= 0 && graph->max_weight <= 1)
+			{
+				printProgressMessage("[OPTIMIZED ALGORITHM (0-1 BFS) - Distances from the given vertice]\n");
+				distances = zeroOneBFS(graph, origin);
+				dijkstra_complexity += ComplexityOf_zeroOneBFS(graph, origin);
+			}
+			else
+			{
+				printProgressMessage("[OPTIMIZED ALGORITHM - Distances from the given vertice]\n");
+				distances = dijkstra(graph, origin, NULL);
+				dijkstra_complexity += ComplexityOf_dijkstra(graph, origin);
+			}
 		#else
 			printProgressMessage("[NAIVE ALGORITHM - Distances from the given vertice]\n");
-			int* distances = dijkstraNaive(graph, origin);
+			int* distances = dijkstraNaive(graph, origin, NULL);
 			dijkstra_complexity += ComplexityOf_dijkstraNaive(graph, origin);
 		#endif
 
@@ -5,16 +5,25 @@
 // Note: the acronym "CDLL" stands for Circular Double-Linked List
 //------------------------------------------------------------------------------
 
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <assert.h>
 #include <time.h>
+#include <unistd.h>
 #include "toolbox.h"
 #include "complexity.h"
 #include "fibonacci_heap.h"
 #include "main_test.h"
 #include "graph.h"
 #include "dijkstra.h"
+#include "delta_stepping.h"
+#include "dynamic_sssp.h"
+#include "distance_table.h"
+#include "sssp_cache.h"
+#include "connectivity.h"
 
 // Random nodes generation parameters
 #define NB_GEN_NODES 8
@@ -62,6 +71,47 @@ void deleteNodesArray (Node** node_array, int size)
 	free(node_array);
 }
 
+// Fixed graph for the tests comparing an algorithm to dijkstraNaive:
+// - the first 3/4 of the vertexes form a connected component (a path plus
+//   chords), with weights spread between min_weight and max_weight
+// - the last 1/4 form another component, unreachable from vertex 0
+Graph* generateFixedGraph (int nb_vertexes, int min_weight, int max_weight)
+{
+	Graph* g = createEmptyGraph(nb_vertexes);
+
+	int first_size  = (3 * nb_vertexes) / 4;
+	int nb_weights  = max_weight - min_weight + 1;
+	int weight;
+
+	for (int i = 0; i < nb_vertexes - 1; i++)
+	{
+		if (i == first_size - 1)
+			continue;
+
+		int first  = i < first_size ? 0 : first_size;
+		int size   = i < first_size ? first_size : nb_vertexes - first_size;
+		int chord  = first + (7 * (i - first) + 5) % size;
+
+		addUndirectedEdgeToGraph(g, i, i + 1, min_weight + (37 * i + 11) % nb_weights);
+
+		if (chord != i && !getEdgeWeight(g, i, chord, &weight))
+			addUndirectedEdgeToGraph(g, i, chord, min_weight + (13 * i + 3) % nb_weights);
+	}
+
+	return g;
+}
+
+// Number of vertexes whose length differs from the expected one
+int countWrongLengths (int* lengths, int* expected, int nb_vertexes)
+{
+	int nb_errors = 0;
+	for (int i = 0; i < nb_vertexes; i++)
+		if (lengths[i] != expected[i])
+			nb_errors++;
+
+	return nb_errors;
+}
+
 void testNodes_1 ()
 {
 	printProgressMessage("\n--------- TEST OF NODES ---------\n");
@@ -157,7 +207,7 @@ void testGraph_1 ()
 		int origin = 0;
 		printProgressMessage("[Distances from vertice 0]\n");
 
-		int* res= dijkstraNaive(g, origin);
+		int* res= dijkstraNaive(g, origin, NULL);
 		for (int i = 0; i < g->nb_vertexes; i++)
 			printf("Distance from %d to %d is: %d\n", origin, i, res[i]);
 	}
@@ -316,7 +366,7 @@ void testGraph_2 ()
 		int origin = 0;
 		printProgressMessage("[Distances from vertice 0]\n");
 
-		int* res = dijkstra(g, origin);
+		int* res = dijkstra(g, origin, NULL);
 		for (int i = 0; i < g->nb_vertexes; i++)
 			printf("Distance from %d to %d is: %d\n", origin, i, res[i]);
 	}
@@ -326,6 +376,284 @@ void testGraph_2 ()
 	}
 }
 
+void testDeltaStepping_1 ()
+{
+	printProgressMessage("\n--------- TEST OF DELTA-STEPPING 1 ---------\n");
+
+	printProgressMessage("[A fixed graph with 200 vertexes is created]\n");
+	Graph* g = generateFixedGraph(200, 1, 20);
+
+	int origin = 0;
+	int* expected = dijkstraNaive(g, origin, NULL);
+
+	printProgressMessage("[Delta-stepping is compared to the naive algorithm]\n");
+
+	// Delta 0 is the default width, delta 1 amounts to Dijkstra, and a delta
+	// larger than all the lengths puts every vertex in the first bucket
+	int deltas[4] = {0, 1, 7, 100000};
+	for (int d = 0; d < 4; d++)
+		for (int nb_threads = 1; nb_threads <= 4; nb_threads *= 2)
+		{
+			int* res = deltaStepping(g, origin, deltas[d], nb_threads);
+			int nb_errors = countWrongLengths(res, expected, g->nb_vertexes);
+
+			printf("Delta %d, %d thread(s): %d wrong distance(s)\n",
+				deltas[d], nb_threads, nb_errors);
+			assert(nb_errors == 0);
+
+			free(res);
+		}
+
+	//---------- Cleaning ----------
+
+	free(expected);
+	freeGraph(g);
+}
+
+void testDynamicSSSP_1 ()
+{
+	printProgressMessage("\n--------- TEST OF DYNAMIC SSSP 1 ---------\n");
+
+	printProgressMessage("[A fixed graph with 150 vertexes is created]\n");
+	Graph* g = generateFixedGraph(150, 1, 20);
+
+	int origin = 0;
+	DynamicSSSP* sssp = createDynamicSSSP(g, origin);
+
+	printProgressMessage("[Batches of weight updates are compared to the naive algorithm]\n");
+
+	// Each batch updates the first edge of 10 vertexes, increasing half of
+	// them and decreasing (possibly to 0) the other half
+	EdgeWeightUpdate updates[10];
+	for (int batch = 0; batch < 6; batch++)
+	{
+		for (int k = 0; k < 10; k++)
+		{
+			int vertex = (17 * batch + 29 * k) % g->nb_vertexes;
+			Edge* edge = g->edges[vertex];
+
+			updates[k].origin 	   = edge->origin;
+			updates[k].destination = edge->destination;
+			updates[k].new_weight  = (batch + k) % 2 == 0
+								   ? edge->weight + 10 + k
+								   : edge->weight / 2;
+		}
+
+		applyEdgeWeightUpdates(sssp, updates, 10);
+
+		int* expected  = dijkstraNaive(g, origin, NULL);
+		int nb_errors  = countWrongLengths(sssp->lengths, expected, g->nb_vertexes);
+
+		printf("Batch %d: %d wrong distance(s)\n", batch + 1, nb_errors);
+		assert(nb_errors == 0);
+
+		free(expected);
+	}
+
+	//---------- Cleaning ----------
+
+	freeDynamicSSSP(sssp);
+	freeGraph(g);
+}
+
+void testDistanceTable_1 ()
+{
+	printProgressMessage("\n--------- TEST OF DISTANCE TABLES 1 ---------\n");
+
+	printProgressMessage("[A fixed graph with 120 vertexes is created]\n");
+	Graph* g = generateFixedGraph(120, 1, 20);
+
+	// Some targets (and sources) lie in the component unreachable from the others
+	int sources[6] = {0, 17, 45, 89, 95, 119};
+	int targets[5] = {3, 60, 89, 100, 118};
+
+	int* expected[6];
+	for (int i = 0; i < 6; i++)
+		expected[i] = dijkstraNaive(g, sources[i], NULL);
+
+	printProgressMessage("[Distance tables are compared to the naive algorithm]\n");
+
+	// A budget of 1 reduces the buckets to the targets themselves, and a
+	// large budget makes the backward searches exhaustive
+	int bucket_budgets[4] = {0, 1, 8, 1000};
+	for (int b = 0; b < 4; b++)
+		for (int nb_threads = 1; nb_threads <= 3; nb_threads += 2)
+		{
+			DistanceTable* table = computeDistanceTable(g, sources, 6, targets, 5,
+														bucket_budgets[b], nb_threads);
+
+			int nb_errors = 0;
+			for (int i = 0; i < 6; i++)
+				for (int j = 0; j < 5; j++)
+					if (table->lengths[i * 5 + j] != expected[i][targets[j]])
+						nb_errors++;
+
+			printf("Bucket budget %d, %d thread(s): %d wrong distance(s)\n",
+				bucket_budgets[b], nb_threads, nb_errors);
+			assert(nb_errors == 0);
+
+			freeDistanceTable(table);
+		}
+
+	//---------- Cleaning ----------
+
+	for (int i = 0; i < 6; i++)
+		free(expected[i]);
+	freeGraph(g);
+}
+
+void testSSSPCache_1 ()
+{
+	printProgressMessage("\n--------- TEST OF SSSP CACHES 1 ---------\n");
+
+	printProgressMessage("[A fixed graph with 100 vertexes is created]\n");
+	Graph* g = generateFixedGraph(100, 1, 20);
+	uint64_t fingerprint = computeGraphFingerprint(g);
+
+	// The budget holds the lengths from two sources, and evicted lengths are
+	// spilled to a new temporary directory
+	char spill_directory[] = "/tmp/sssp_cache_test_XXXXXX";
+	if (mkdtemp(spill_directory) == NULL)
+	{
+		fprintf(stderr, "Error: temporary directory cannot be created.\n");
+		exit(1);
+	}
+
+	size_t entry_size = sizeof(CachedLengths) + g->nb_vertexes * sizeof(int);
+	SSSPCache* cache  = createSSSPCache(2 * entry_size, spill_directory);
+
+	// Queries: two misses, a hit on 0 (which becomes the most recent), a miss
+	// evicting 10 (the least recent), and a reload of 10 from the spill
+	int queries[5] = {0, 10, 0, 20, 10};
+
+	printProgressMessage("[Cached lengths are compared to the naive algorithm]\n");
+	for (int q = 0; q < 5; q++)
+	{
+		int* lengths  = getCachedShortestPathLengths(cache, g, fingerprint, queries[q]);
+		int* expected = dijkstraNaive(g, queries[q], NULL);
+		int nb_errors = countWrongLengths(lengths, expected, g->nb_vertexes);
+
+		printf("Source %d: %d wrong distance(s)\n", queries[q], nb_errors);
+		assert(nb_errors == 0);
+
+		if (queries[q] == 20)
+		{
+			assert(findCachedLengths(cache, fingerprint, 10) == NULL);
+			assert(findCachedLengths(cache, fingerprint, 0) != NULL);
+		}
+
+		free(expected);
+	}
+
+	printf("%ld hit(s), %ld spill hit(s), %ld miss(es)\n",
+		cache->nb_hits, cache->nb_spill_hits, cache->nb_misses);
+	assert(cache->nb_hits == 1);
+	assert(cache->nb_spill_hits == 1);
+	assert(cache->nb_misses == 3);
+
+	//---------- Cleaning ----------
+
+	char path[4096];
+	for (int q = 0; q < 5; q++)
+	{
+		getSpillFilePath(cache, fingerprint, queries[q], path, sizeof(path));
+		remove(path);
+	}
+	rmdir(spill_directory);
+
+	freeSSSPCache(cache);
+
+	freeGraph(g);
+}
+
+void testConnectivity_1 ()
+{
+	printProgressMessage("\n--------- TEST OF CONNECTIVITY 1 ---------\n");
+
+	// The fixed graph has two components, and isolated vertexes are added
+	printProgressMessage("[A fixed graph with 300 vertexes (and 20 isolated ones) is created]\n");
+	Graph* fixed_graph = generateFixedGraph(300, 1, 20);
+	Graph* g = createEmptyGraph(320);
+	for (int i = 0; i < 300; i++)
+		for (Edge* edge = fixed_graph->edges[i]; edge != NULL; edge = edge->next)
+			if (edge->origin < edge->destination)
+				addUndirectedEdgeToGraph(g, edge->origin, edge->destination, edge->weight);
+
+	Components* expected = computeConnectedComponents(g);
+	printf("%d components\n", expected->nb_components);
+
+	printProgressMessage("[Afforest labels are compared to the union-find labels]\n");
+	for (int nb_threads = 1; nb_threads <= 4; nb_threads *= 2)
+	{
+		Components* components = computeConnectedComponentsInParallel(g, nb_threads);
+		assert(components->nb_components == expected->nb_components);
+
+		int nb_errors = 0;
+		for (int i = 0; i < g->nb_vertexes; i++)
+			if (components->labels[i] != expected->labels[i])
+				nb_errors++;
+		for (int c = 0; c < expected->nb_components; c++)
+			if (components->sizes[c] != expected->sizes[c])
+				nb_errors++;
+
+		printf("%d thread(s): %d wrong label(s) or size(s)\n", nb_threads, nb_errors);
+		assert(nb_errors == 0);
+
+		freeComponents(components);
+	}
+
+	int nb_size_classes;
+	int* histogram = computeComponentSizeHistogram(expected, &nb_size_classes);
+
+	// 20 isolated vertexes (class 0), and components of 75 (class 6) and 225
+	// (class 7) vertexes
+	assert(histogram[0] == 20 && histogram[6] == 1 && histogram[7] == 1);
+
+	//---------- Cleaning ----------
+
+	free(histogram);
+	freeComponents(expected);
+	freeGraph(fixed_graph);
+	freeGraph(g);
+}
+
+void testBreadthFirstSearch_1 ()
+{
+	printProgressMessage("\n--------- TEST OF BREADTH-FIRST SEARCH 1 ---------\n");
+
+	// Both graphs have the same edges: the hop counts in the weighted graph are
+	// the lengths in the unit-weight one (the search goes bottom-up in between)
+	printProgressMessage("[A fixed graph with 400 vertexes, and its unit-weight copy, are created]\n");
+	Graph* g 			 = generateFixedGraph(400, 1, 20);
+	Graph* unit_weight_g = generateFixedGraph(400, 1, 1);
+
+	printProgressMessage("[Hop counts are compared to the naive algorithm]\n");
+	int origins[2] = {0, 350};
+	for (int o = 0; o < 2; o++)
+	{
+		int* expected = dijkstraNaive(unit_weight_g, origins[o], NULL);
+
+		for (int nb_threads = 1; nb_threads <= 4; nb_threads *= 2)
+		{
+			int* depths = breadthFirstSearch(g, origins[o], nb_threads);
+			int nb_errors = countWrongLengths(depths, expected, g->nb_vertexes);
+
+			printf("Origin %d, %d thread(s): %d wrong hop count(s)\n",
+				origins[o], nb_threads, nb_errors);
+			assert(nb_errors == 0);
+
+			free(depths);
+		}
+
+		free(expected);
+	}
+
+	//---------- Cleaning ----------
+
+	freeGraph(g);
+	freeGraph(unit_weight_g);
+}
+
 int main ()
 {
 	srand(time(0));
@@ -336,6 +664,12 @@ int main ()
 	testFibonacciHeaps_2();
 	testFibonacciHeaps_3();
 	// testGraph_2();
+	testDeltaStepping_1();
+	testDynamicSSSP_1();
+	testDistanceTable_1();
+	testSSSPCache_1();
+	testConnectivity_1();
+	testBreadthFirstSearch_1();
 
 	return 0;
 }
@@ -6,10 +6,13 @@
 #define _MAIN_TEST_H
 
 #include "fibonacci_heap.h"
+#include "graph.h"
 
 Node** generateFixedNodesArray (int nb_nodes);
 Node** generateRandomNodesArray (int nb_nodes);
 void deleteNodesArray (Node** node_array, int size);
+Graph* generateFixedGraph (int nb_vertexes, int min_weight, int max_weight);
+int countWrongLengths (int* lengths, int* expected, int nb_vertexes);
 
 int main ();
 
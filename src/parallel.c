@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+// PARALLELISM
+//------------------------------------------------------------------------------
+// Small helpers shared by the multithreaded algorithms (POSIX threads):
+// - fork-join execution of a task over a given number of threads
+// - pinning of a thread to some cores
+// - atomic operations on shared arrays
+//------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "toolbox.h"
+#include "parallel.h"
+
+// Arguments given to every spawned thread
+typedef struct ThreadArguments
+{
+	ParallelTask task;
+	void* argument;
+	int thread_num;
+	int nb_threads;
+} ThreadArguments;
+
+//------------------------------------------------------------------------------
+
+int getNbAvailableCores ()
+{
+	long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return nb_cores < 1 ? 1 : (int) nb_cores;
+}
+
+void* runThreadTask (void* thread_arguments)
+{
+	ThreadArguments* arguments = thread_arguments;
+	arguments->task(arguments->thread_num, arguments->nb_threads, arguments->argument);
+
+	return NULL;
+}
+
+// Run the task on nb_threads threads, and wait for all of them to finish
+// The calling thread is used as the thread number 0
+void runInParallel (int nb_threads, ParallelTask task, void* argument)
+{
+	assert(nb_threads >= 1);
+
+	if (nb_threads == 1)
+	{
+		task(0, 1, argument);
+		return;
+	}
+
+	pthread_t* threads = malloc(nb_threads * sizeof(pthread_t));
+	CHECK_MALLOC(threads);
+	ThreadArguments* arguments = malloc(nb_threads * sizeof(ThreadArguments));
+	CHECK_MALLOC(arguments);
+
+	for (int i = 0; i < nb_threads; i++)
+	{
+		arguments[i].task 		= task;
+		arguments[i].argument 	= argument;
+		arguments[i].thread_num = i;
+		arguments[i].nb_threads = nb_threads;
+	}
+
+	for (int i = 1; i < nb_threads; i++)
+	{
+		int error = pthread_create(&threads[i], NULL, runThreadTask, &arguments[i]);
+		if (error != 0)
+		{
+			fprintf(stderr, "Error: thread creation failed.\n");
+			exit(1);
+		}
+	}
+
+	runThreadTask(&arguments[0]);
+
+	for (int i = 1; i < nb_threads; i++)
+		pthread_join(threads[i], NULL);
+
+	free(arguments);
+	free(threads);
+}
+
+// Restrict the calling thread (and the threads it will create) to nb_cores
+// consecutive cores, starting from first_core (wrapping around the available
+// cores); returns false if the affinity could not be set
+bool pinCurrentThreadToCores (int first_core, int nb_cores)
+{
+	int nb_available_cores = getNbAvailableCores();
+
+	cpu_set_t cores;
+	CPU_ZERO(&cores);
+	for (int i = 0; i < nb_cores; i++)
+		CPU_SET((first_core + i) % nb_available_cores, &cores);
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cores) == 0;
+}
+
+//------------------------------------------------------------------------------
+// ATOMIC OPERATIONS
+//------------------------------------------------------------------------------
+
+// Atomically replace *address by value if value is smaller
+// Returns true if the value has been written
+bool atomicMinUnsigned (unsigned int* address, unsigned int value)
+{
+	unsigned int current = __atomic_load_n(address, __ATOMIC_RELAXED);
+
+	while (value < current)
+	{
+		if (__atomic_compare_exchange_n(address, &current, value, true,
+										__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return true;
+	}
+
+	return false;
+}
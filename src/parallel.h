@@ -0,0 +1,22 @@
+//------------------------------------------------------------------------------
+// PARALLELISM
+//------------------------------------------------------------------------------
+
+#ifndef _PARALLEL_H
+#define _PARALLEL_H
+
+#include <stdbool.h>
+
+// Task run by each thread of a parallel region
+typedef void (*ParallelTask) (int thread_num, int nb_threads, void* argument);
+
+//------------------------------------------------------------------------------
+
+int getNbAvailableCores ();
+void* runThreadTask (void* thread_arguments);
+void runInParallel (int nb_threads, ParallelTask task, void* argument);
+bool pinCurrentThreadToCores (int first_core, int nb_cores);
+
+bool atomicMinUnsigned (unsigned int* address, unsigned int value);
+
+#endif
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+// PSEUDO-RANDOM NUMBER GENERATOR
+//------------------------------------------------------------------------------
+// Fast, seedable pseudo-random numbers: xoshiro256** (Blackman & Vigna),
+// whose state is initialized with SplitMix64.
+// A generator is identified by a seed and a stream number: generators of
+// different streams are independent, which lets every thread (or every piece
+// of work) draw its own numbers, whatever the order in which they are run.
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "prng.h"
+
+// 2^-53, to convert 53 random bits into a double
+#define DOUBLE_UNIT (1.0 / 9007199254740992.0)
+
+//------------------------------------------------------------------------------
+
+uint64_t getNextSplitMix64 (uint64_t* state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+// The stream is mixed into the seed before the state is expanded, so that
+// close (seed, stream) couples give unrelated states
+void seedPrng (Prng* prng, uint64_t seed, uint64_t stream)
+{
+	uint64_t stream_state = stream;
+	uint64_t splitmix_state = seed ^ getNextSplitMix64(&stream_state);
+
+	for (int i = 0; i < 4; i++)
+		prng->state[i] = getNextSplitMix64(&splitmix_state);
+}
+
+uint64_t rotateLeft (uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+uint64_t getNextRandom (Prng* prng)
+{
+	uint64_t* s = prng->state;
+	uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3]  = rotateLeft(s[3], 45);
+
+	return result;
+}
+
+// Uniform in [0, bound[ (bound > 0), without modulo bias (rejection)
+uint64_t getRandomBoundedUint64 (Prng* prng, uint64_t bound)
+{
+	uint64_t threshold = (0 - bound) % bound; // (2^64 - bound) mod bound
+	uint64_t x;
+
+	do
+		x = getNextRandom(prng);
+	while (x < threshold);
+
+	return x % bound;
+}
+
+// Uniform in [min, max]
+int getRandomIntInRange (Prng* prng, int min, int max)
+{
+	uint64_t range = (uint64_t) ((int64_t) max - (int64_t) min) + 1;
+	return (int) ((int64_t) min + (int64_t) getRandomBoundedUint64(prng, range));
+}
+
+// Uniform in [0, 1[
+double getRandomUnitDouble (Prng* prng)
+{
+	return (double) (getNextRandom(prng) >> 11) * DOUBLE_UNIT;
+}
+
+// Uniform in ]0, 1[
+double getRandomOpenUnitDouble (Prng* prng)
+{
+	return ((double) (getNextRandom(prng) >> 11) + 0.5) * DOUBLE_UNIT;
+}
@@ -0,0 +1,28 @@
+//------------------------------------------------------------------------------
+// PSEUDO-RANDOM NUMBER GENERATOR
+//------------------------------------------------------------------------------
+
+#ifndef _PRNG_H
+#define _PRNG_H
+
+#include <stdint.h>
+
+// State of a xoshiro256** generator
+typedef struct Prng
+{
+	uint64_t state[4];
+} Prng;
+
+//------------------------------------------------------------------------------
+
+uint64_t getNextSplitMix64 (uint64_t* state);
+void seedPrng (Prng* prng, uint64_t seed, uint64_t stream);
+
+uint64_t rotateLeft (uint64_t x, int k);
+uint64_t getNextRandom (Prng* prng);
+uint64_t getRandomBoundedUint64 (Prng* prng, uint64_t bound);
+int getRandomIntInRange (Prng* prng, int min, int max);
+double getRandomUnitDouble (Prng* prng);
+double getRandomOpenUnitDouble (Prng* prng);
+
+#endif
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+// SMALL-WEIGHT SHORTEST PATHS
+//------------------------------------------------------------------------------
+// Single-source shortest paths specialised for small integer weights, where a
+// heap is not needed to find the next vertex to settle:
+// - 0-1 BFS, if all the weights are 0 or 1: a deque, in which a vertex reached
+//   through a null edge is pushed at the front, and otherwise at the back
+//   (O(#S + #A))
+// - Dial's algorithm, if all the weights are <= C: buckets of vertexes having
+//   the same tentative length, used cyclically (C + 1 buckets are enough)
+//   (O(#A + max length))
+// The algorithm is selected according to the weight bounds of the graph.
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "toolbox.h"
+#include "list.h"
+#include "graph.h"
+#include "dijkstra.h"
+#include "small_weight_sssp.h"
+
+//------------------------------------------------------------------------------
+// 0-1 BFS
+//------------------------------------------------------------------------------
+
+// All the weights must be 0 or 1
+// The returned lengths follow the conventions of dijkstraNaive()
+int* zeroOneBFS (Graph* g, int s)
+{
+	int* lengths = malloc(g->nb_vertexes * sizeof(int));
+	CHECK_MALLOC(lengths);
+	bool* settled = calloc(g->nb_vertexes, sizeof(bool));
+	CHECK_MALLOC(settled);
+
+	for (int i = 0; i < g->nb_vertexes; i++)
+		lengths[i] = INF_LENGTH;
+
+	Queue deque;
+	initQueue(&deque);
+
+	lengths[s] = 0;
+	pushBackToQueue(&deque, s);
+
+	// The deque is sorted by length, and holds at most two distinct lengths
+	while (! queueIsEmpty(&deque))
+	{
+		int vertex = popFrontFromQueue(&deque);
+
+		// A vertex can be pushed once per improvement: only the first pop counts
+		if (settled[vertex])
+			continue;
+		settled[vertex] = true;
+
+		for (Edge* edge = g->edges[vertex]; edge != NULL; edge = edge->next)
+		{
+			int neighbour  = edge->destination;
+			int new_length = lengths[vertex] + edge->weight;
+
+			if (lengths[neighbour] == INF_LENGTH || new_length < lengths[neighbour])
+			{
+				lengths[neighbour] = new_length;
+
+				if (edge->weight == 0)
+					pushFrontToQueue(&deque, neighbour);
+				else
+					pushBackToQueue(&deque, neighbour);
+			}
+		}
+	}
+
+	freeQueueContent(&deque);
+	free(settled);
+
+	return lengths;
+}
+
+//------------------------------------------------------------------------------
+// DIAL'S ALGORITHM
+//------------------------------------------------------------------------------
+
+// All the weights must be between 0 and g->max_weight (which should be small)
+// The returned lengths follow the conventions of dijkstraNaive()
+int* dialDijkstra (Graph* g, int s)
+{
+	int max_weight = g->max_weight < 0 ? 0 : g->max_weight;
+	int nb_buckets = max_weight + 1;
+
+	int* lengths = malloc(g->nb_vertexes * sizeof(int));
+	CHECK_MALLOC(lengths);
+	bool* settled = calloc(g->nb_vertexes, sizeof(bool));
+	CHECK_MALLOC(settled);
+	Stack* buckets = calloc(nb_buckets, sizeof(Stack));
+	CHECK_MALLOC(buckets);
+
+	for (int i = 0; i < g->nb_vertexes; i++)
+		lengths[i] = INF_LENGTH;
+
+	lengths[s] = 0;
+	pushToStack(&buckets[0], s);
+	long nb_entries = 1;
+
+	// The bucket of the current length only contains vertexes at this length,
+	// and the other ones the vertexes at one of the next max_weight lengths
+	for (int length = 0; nb_entries > 0; length++)
+	{
+		Stack* bucket = &buckets[length % nb_buckets];
+
+		// Null edges add vertexes to the current bucket, while it is emptied
+		while (! stackIsEmpty(bucket))
+		{
+			int vertex = popFromStack(bucket);
+			nb_entries--;
+
+			// Outdated entry (the vertex has been improved since it was added)
+			if (settled[vertex] || lengths[vertex] != length)
+				continue;
+			settled[vertex] = true;
+
+			for (Edge* edge = g->edges[vertex]; edge != NULL; edge = edge->next)
+			{
+				int neighbour  = edge->destination;
+				int new_length = length + edge->weight;
+
+				if (lengths[neighbour] == INF_LENGTH || new_length < lengths[neighbour])
+				{
+					lengths[neighbour] = new_length;
+					pushToStack(&buckets[new_length % nb_buckets], neighbour);
+					nb_entries++;
+				}
+			}
+		}
+	}
+
+	for (int b = 0; b < nb_buckets; b++)
+		freeStackContent(&buckets[b]);
+	free(buckets);
+	free(settled);
+
+	return lengths;
+}
+
+//------------------------------------------------------------------------------
+// ALGORITHM SELECTION
+//------------------------------------------------------------------------------
+
+// Lengths from s, with the fastest algorithm for the weights of the graph
+// The returned lengths follow the conventions of dijkstraNaive()
+int* computeShortestPathLengths (Graph* g, int s)
+{
+	if (g->min_weight >= 0 && g->max_weight <= 1)
+		return zeroOneBFS(g, s);
+
+	if (g->min_weight >= 0 && g->max_weight <= DIAL_MAX_WEIGHT)
+		return dialDijkstra(g, s);
+
+	return dijkstra(g, s, NULL);
+}
@@ -0,0 +1,19 @@
+//------------------------------------------------------------------------------
+// SMALL-WEIGHT SHORTEST PATHS
+//------------------------------------------------------------------------------
+
+#ifndef _SMALL_WEIGHT_SSSP_H
+#define _SMALL_WEIGHT_SSSP_H
+
+#include "graph.h"
+
+// Largest edge weight for which Dial's algorithm is preferred to Dijkstra's
+#define DIAL_MAX_WEIGHT 64
+
+//------------------------------------------------------------------------------
+
+int* zeroOneBFS (Graph* g, int s);
+int* dialDijkstra (Graph* g, int s);
+int* computeShortestPathLengths (Graph* g, int s);
+
+#endif
@@ -0,0 +1,364 @@
+//------------------------------------------------------------------------------
+// SSSP CACHE
+//------------------------------------------------------------------------------
+// Cache in front of the shortest paths algorithms, for services which repeatedly ask for
+// the lengths from the same sources in an unchanged graph.
+// Results are identified by (fingerprint of the graph, source): the fingerprint
+// is a hash of the whole content of the graph, computed once by the caller
+// (and again after any modification of the graph).
+// The results are kept in a hash table, and in a LRU list used to evict them
+// when the memory budget is exceeded. Evicted results can be spilled to a
+// directory, from which they are loaded back instead of being recomputed.
+// The cache is not thread-safe.
+//------------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+#include "toolbox.h"
+#include "graph.h"
+#include "small_weight_sssp.h"
+#include "sssp_cache.h"
+
+#define INITIAL_NB_CACHE_SLOTS 64
+#define MAX_SPILL_PATH_LENGTH  4096
+
+//------------------------------------------------------------------------------
+// FINGERPRINT
+//------------------------------------------------------------------------------
+
+// Hash of the number of vertexes and of every (origin, destination, weight)
+// O(#S + #A)
+uint64_t computeGraphFingerprint (Graph* g)
+{
+	uint64_t hash = hashInteger(FNV_OFFSET_BASIS, g->nb_vertexes);
+
+	for (int i = 0; i < g->nb_vertexes; i++)
+	{
+		hash = hashInteger(hash, -1); // Separator between the adjacency lists
+
+		for (Edge* edge = g->edges[i]; edge != NULL; edge = edge->next)
+		{
+			hash = hashInteger(hash, edge->destination);
+			hash = hashInteger(hash, edge->weight);
+		}
+	}
+
+	return hash;
+}
+
+//------------------------------------------------------------------------------
+// CACHE STRUCTURE
+//------------------------------------------------------------------------------
+
+// The spill directory is copied (NULL to disable spilling)
+SSSPCache* createSSSPCache (size_t memory_budget, char* spill_directory)
+{
+	SSSPCache* cache = malloc(sizeof(SSSPCache));
+	CHECK_MALLOC(cache);
+
+	cache->memory_budget = memory_budget;
+	cache->memory_used 	 = 0;
+
+	cache->spill_directory = NULL;
+	if (spill_directory != NULL)
+	{
+		cache->spill_directory = malloc(strlen(spill_directory) + 1);
+		CHECK_MALLOC(cache->spill_directory);
+		strcpy(cache->spill_directory, spill_directory);
+	}
+
+	cache->nb_slots   = INITIAL_NB_CACHE_SLOTS;
+	cache->nb_entries = 0;
+	cache->slots 	  = calloc(cache->nb_slots, sizeof(CachedLengths*));
+	CHECK_MALLOC(cache->slots);
+
+	cache->most_recent 	= NULL;
+	cache->least_recent = NULL;
+
+	cache->nb_hits 		 = 0;
+	cache->nb_spill_hits = 0;
+	cache->nb_misses 	 = 0;
+
+	return cache;
+}
+
+// The spilled files are kept
+void freeSSSPCache (SSSPCache* cache)
+{
+	CachedLengths* entry = cache->most_recent;
+	while (entry != NULL)
+	{
+		CachedLengths* next_entry = entry->less_recent;
+
+		free(entry->lengths);
+		free(entry);
+
+		entry = next_entry;
+	}
+
+	free(cache->slots);
+	free(cache->spill_directory);
+	free(cache);
+}
+
+int getCacheSlot (SSSPCache* cache, uint64_t fingerprint, int source)
+{
+	uint64_t hash = hashInteger(fingerprint, source);
+	return (int) (hash & (uint64_t) (cache->nb_slots - 1));
+}
+
+// Double the number of slots (the load factor stays below 1)
+void growCacheSlots (SSSPCache* cache)
+{
+	CachedLengths** old_slots = cache->slots;
+	int old_nb_slots 		  = cache->nb_slots;
+
+	cache->nb_slots *= 2;
+	cache->slots = calloc(cache->nb_slots, sizeof(CachedLengths*));
+	CHECK_MALLOC(cache->slots);
+
+	for (int i = 0; i < old_nb_slots; i++)
+	{
+		CachedLengths* entry = old_slots[i];
+		while (entry != NULL)
+		{
+			CachedLengths* next_entry = entry->next_in_slot;
+
+			int slot = getCacheSlot(cache, entry->fingerprint, entry->source);
+			entry->next_in_slot = cache->slots[slot];
+			cache->slots[slot] 	= entry;
+
+			entry = next_entry;
+		}
+	}
+
+	free(old_slots);
+}
+
+CachedLengths* findCachedLengths (SSSPCache* cache, uint64_t fingerprint, int source)
+{
+	int slot = getCacheSlot(cache, fingerprint, source);
+
+	for (CachedLengths* entry = cache->slots[slot]; entry != NULL; entry = entry->next_in_slot)
+		if (entry->fingerprint == fingerprint && entry->source == source)
+			return entry;
+
+	return NULL;
+}
+
+// Insert a new entry, as the most recently used one
+void insertCachedLengths (SSSPCache* cache, CachedLengths* entry)
+{
+	if (cache->nb_entries >= cache->nb_slots)
+		growCacheSlots(cache);
+
+	int slot = getCacheSlot(cache, entry->fingerprint, entry->source);
+	entry->next_in_slot = cache->slots[slot];
+	cache->slots[slot] 	= entry;
+
+	entry->more_recent = NULL;
+	entry->less_recent = cache->most_recent;
+	if (cache->most_recent != NULL)
+		cache->most_recent->more_recent = entry;
+	else
+		cache->least_recent = entry;
+	cache->most_recent = entry;
+
+	(cache->nb_entries)++;
+	cache->memory_used += sizeof(CachedLengths) + entry->nb_vertexes * sizeof(int);
+}
+
+// Remove an entry from the hash table and the LRU list (without freeing it)
+void removeCachedLengths (SSSPCache* cache, CachedLengths* entry)
+{
+	int slot = getCacheSlot(cache, entry->fingerprint, entry->source);
+
+	CachedLengths** link = &cache->slots[slot];
+	while (*link != entry)
+		link = &(*link)->next_in_slot;
+	*link = entry->next_in_slot;
+
+	if (entry->more_recent != NULL)
+		entry->more_recent->less_recent = entry->less_recent;
+	else
+		cache->most_recent = entry->less_recent;
+
+	if (entry->less_recent != NULL)
+		entry->less_recent->more_recent = entry->more_recent;
+	else
+		cache->least_recent = entry->more_recent;
+
+	(cache->nb_entries)--;
+	cache->memory_used -= sizeof(CachedLengths) + entry->nb_vertexes * sizeof(int);
+}
+
+void markAsMostRecent (SSSPCache* cache, CachedLengths* entry)
+{
+	if (cache->most_recent == entry)
+		return;
+
+	// Unlink (the entry is not the most recent one, so more_recent is not NULL)
+	entry->more_recent->less_recent = entry->less_recent;
+	if (entry->less_recent != NULL)
+		entry->less_recent->more_recent = entry->more_recent;
+	else
+		cache->least_recent = entry->more_recent;
+
+	// Link at the head
+	entry->more_recent = NULL;
+	entry->less_recent = cache->most_recent;
+	cache->most_recent->more_recent = entry;
+	cache->most_recent = entry;
+}
+
+// Evict the least recently used entries until the budget is respected
+// The protected entry (the one just returned to the caller) is always kept
+void evictLeastRecentLengths (SSSPCache* cache, CachedLengths* protected_entry)
+{
+	while (cache->memory_used > cache->memory_budget
+	   &&  cache->least_recent != NULL
+	   &&  cache->least_recent != protected_entry)
+	{
+		CachedLengths* entry = cache->least_recent;
+
+		if (cache->spill_directory != NULL && ! entry->is_spilled)
+			spillCachedLengths(cache, entry);
+
+		removeCachedLengths(cache, entry);
+		free(entry->lengths);
+		free(entry);
+	}
+}
+
+//------------------------------------------------------------------------------
+// SPILL FILES
+//------------------------------------------------------------------------------
+
+// <spill directory>/<fingerprint>_<source>.bin
+void getSpillFilePath (SSSPCache* cache, uint64_t fingerprint, int source, char* path, size_t path_size)
+{
+	int length = snprintf(path, path_size, "%s/%016" PRIx64 "_%d.bin",
+						  cache->spill_directory, fingerprint, source);
+
+	if (length < 0 || (size_t) length >= path_size)
+	{
+		fprintf(stderr, "Error: spill directory path is too long.\n");
+		exit(1);
+	}
+}
+
+// A failed spill only means the result will have to be recomputed
+void spillCachedLengths (SSSPCache* cache, CachedLengths* entry)
+{
+	char path[MAX_SPILL_PATH_LENGTH];
+	getSpillFilePath(cache, entry->fingerprint, entry->source, path, sizeof(path));
+
+	FILE* file = fopen(path, "wb");
+	if (file == NULL)
+		return;
+
+	SSSPCacheFileHeader header;
+	memcpy(header.magic, SSSP_CACHE_FILE_MAGIC, 4);
+	header.source 	   = entry->source;
+	header.fingerprint = entry->fingerprint;
+	header.nb_vertexes = entry->nb_vertexes;
+	header.reserved    = 0;
+
+	size_t nb_vertexes = entry->nb_vertexes;
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1
+				&& fwrite(entry->lengths, sizeof(int32_t), nb_vertexes, file) == nb_vertexes;
+
+	if (fclose(file) != 0 || ! success)
+	{
+		remove(path);
+		return;
+	}
+
+	entry->is_spilled = true;
+}
+
+// Returns NULL if there is no valid spilled file for this result
+int* loadSpilledLengths (SSSPCache* cache, uint64_t fingerprint, int source, int nb_vertexes)
+{
+	char path[MAX_SPILL_PATH_LENGTH];
+	getSpillFilePath(cache, fingerprint, source, path, sizeof(path));
+
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+
+	SSSPCacheFileHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1
+	||  memcmp(header.magic, SSSP_CACHE_FILE_MAGIC, 4) != 0
+	||  header.fingerprint != fingerprint
+	||  header.source != source
+	||  header.nb_vertexes != nb_vertexes)
+	{
+		fclose(file);
+		return NULL;
+	}
+
+	int* lengths = malloc(nb_vertexes * sizeof(int));
+	CHECK_MALLOC(lengths);
+
+	if (fread(lengths, sizeof(int32_t), nb_vertexes, file) != (size_t) nb_vertexes)
+	{
+		free(lengths);
+		lengths = NULL;
+	}
+
+	fclose(file);
+	return lengths;
+}
+
+//------------------------------------------------------------------------------
+// QUERIES
+//------------------------------------------------------------------------------
+
+// Lengths from s in g (whose fingerprint is given), as returned by dijkstra()
+// (computed by the algorithm suited to the weights of the graph)
+// The returned array belongs to the cache: it must not be modified, and is only
+// valid until the next call on the cache
+int* getCachedShortestPathLengths (SSSPCache* cache, Graph* g, uint64_t fingerprint, int s)
+{
+	CachedLengths* entry = findCachedLengths(cache, fingerprint, s);
+
+	if (entry != NULL)
+	{
+		(cache->nb_hits)++;
+		markAsMostRecent(cache, entry);
+		return entry->lengths;
+	}
+
+	entry = malloc(sizeof(CachedLengths));
+	CHECK_MALLOC(entry);
+
+	entry->fingerprint = fingerprint;
+	entry->source 	   = s;
+	entry->nb_vertexes = g->nb_vertexes;
+	entry->lengths 	   = NULL;
+	entry->is_spilled  = false;
+
+	if (cache->spill_directory != NULL)
+		entry->lengths = loadSpilledLengths(cache, fingerprint, s, g->nb_vertexes);
+
+	if (entry->lengths != NULL)
+	{
+		(cache->nb_spill_hits)++;
+		entry->is_spilled = true;
+	}
+	else
+	{
+		(cache->nb_misses)++;
+		entry->lengths = computeShortestPathLengths(g, s);
+	}
+
+	insertCachedLengths(cache, entry);
+	evictLeastRecentLengths(cache, entry);
+
+	return entry->lengths;
+}
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// SSSP CACHE
+//------------------------------------------------------------------------------
+
+#ifndef _SSSP_CACHE_H
+#define _SSSP_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+// Header of a spilled lengths file, followed by nb_vertexes lengths (int32)
+#define SSSP_CACHE_FILE_MAGIC "SSSP"
+typedef struct SSSPCacheFileHeader
+{
+	char magic[4];
+	int32_t source;
+	uint64_t fingerprint;
+	int32_t nb_vertexes;
+	int32_t reserved;
+} SSSPCacheFileHeader;
+
+// Lengths from a source, in a graph identified by its fingerprint
+typedef struct CachedLengths
+{
+	uint64_t fingerprint;
+	int source;
+	int nb_vertexes;
+	int* lengths;
+	bool is_spilled; // A copy is already in the spill directory
+
+	// Neighbours in the LRU list, and next entry of the same hash table slot
+	struct CachedLengths* more_recent;
+	struct CachedLengths* less_recent;
+	struct CachedLengths* next_in_slot;
+} CachedLengths;
+
+// Cache of the results of the single-source queries, with a memory budget:
+// the least recently used results are evicted (and spilled to the disk if a
+// spill directory is given) when the budget is exceeded
+typedef struct SSSPCache
+{
+	size_t memory_budget; // In bytes (lengths arrays and entries)
+	size_t memory_used;
+	char* spill_directory; // NULL if results are not spilled
+
+	// Hash table (the number of slots is a power of 2)
+	CachedLengths** slots;
+	int nb_slots;
+	int nb_entries;
+
+	// LRU list
+	CachedLengths* most_recent;
+	CachedLengths* least_recent;
+
+	// Statistics
+	long nb_hits;
+	long nb_spill_hits;
+	long nb_misses;
+} SSSPCache;
+
+//------------------------------------------------------------------------------
+
+uint64_t computeGraphFingerprint (Graph* g);
+
+SSSPCache* createSSSPCache (size_t memory_budget, char* spill_directory);
+void freeSSSPCache (SSSPCache* cache);
+
+int getCacheSlot (SSSPCache* cache, uint64_t fingerprint, int source);
+void growCacheSlots (SSSPCache* cache);
+CachedLengths* findCachedLengths (SSSPCache* cache, uint64_t fingerprint, int source);
+void insertCachedLengths (SSSPCache* cache, CachedLengths* entry);
+void removeCachedLengths (SSSPCache* cache, CachedLengths* entry);
+void markAsMostRecent (SSSPCache* cache, CachedLengths* entry);
+void evictLeastRecentLengths (SSSPCache* cache, CachedLengths* protected_entry);
+
+void getSpillFilePath (SSSPCache* cache, uint64_t fingerprint, int source, char* path, size_t path_size);
+void spillCachedLengths (SSSPCache* cache, CachedLengths* entry);
+int* loadSpilledLengths (SSSPCache* cache, uint64_t fingerprint, int source, int nb_vertexes);
+
+int* getCachedShortestPathLengths (SSSPCache* cache, Graph* g, uint64_t fingerprint, int s);
+
+#endif
@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include "fibonacci_heap.h"
+#include "toolbox.h"
 
 // Terminal's display formatting strings
 #define TERM_NORMAL_FORMAT 	"\x1B[0m"
@@ -15,3 +16,44 @@ void printProgressMessage (char* const message)
 {
 	printf("%s%s%s", TERM_ORANGE_TEXT, message, TERM_NORMAL_FORMAT);
 }
+
+// Best SIMD instruction set supported by the CPU running the program
+SimdLevel getSupportedSimdLevel ()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+		return SIMD_AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return SIMD_SSE41;
+#endif
+
+	return SIMD_NONE;
+}
+
+// FNV-1a hash of a sequence of bytes, continued from a previous hash
+// (FNV_OFFSET_BASIS to start a new one)
+uint64_t hashBytes (uint64_t hash, const void* bytes, size_t size)
+{
+	const unsigned char* byte = bytes;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (uint64_t) byte[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+// Hash of the 4 bytes of an integer, in little-endian order whatever the byte
+// order of the machine (so that hashes can be stored in files)
+uint64_t hashInteger (uint64_t hash, int32_t value)
+{
+	unsigned char bytes[4];
+	for (int i = 0; i < 4; i++)
+		bytes[i] = ((uint32_t) value >> (8 * i)) & 0xFF;
+
+	return hashBytes(hash, bytes, 4);
+}
@@ -5,11 +5,29 @@
 #ifndef _TOOLBOX_H
 #define _TOOLBOX_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // Macro to check the correct execution of a malloc() call
 #define CHECK_MALLOC(ptr) assert(ptr != NULL);
 
+// FNV-1a (64 bits) parameters
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 		 1099511628211ULL
+
+// SIMD instruction sets which can be selected at runtime (by increasing order)
+typedef enum SimdLevel
+{
+	SIMD_NONE,
+	SIMD_SSE41,
+	SIMD_AVX2
+} SimdLevel;
+
 //------------------------------------------------------------------------------
 
 void printProgressMessage (char* const message);
+SimdLevel getSupportedSimdLevel ();
+uint64_t hashBytes (uint64_t hash, const void* bytes, size_t size);
+uint64_t hashInteger (uint64_t hash, int32_t value);
 
 #endif